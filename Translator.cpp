@@ -12,10 +12,12 @@
 #include <fstream>
 #include "token.h"
 #include "mypl_exception.h"
+#include "source_file.h"
 #include "lexer.h"
 #include "parser.h"
 #include "ast.h"
 #include "type_checker.h"
+#include "optimizer.h"
 #include "interpreter.h"
 #include "printer.h"
 
@@ -24,14 +26,32 @@ using namespace std;
 int main(int argc, char* argv[])
 {
   // use standard input if no input file given
-  istream* input_stream = &cin;
-  if (argc == 2)
-    input_stream = new ifstream(argv[1]);
+  string file_name;
+  // -O0 translates the program as written, -O1 folds constants, and
+  // -O2 (default) also removes dead code
+  int opt_level = 2;
+  for (int i = 1; i < argc; ++i) {
+    string arg = argv[i];
+    if (arg == "-O0" or arg == "-O1" or arg == "-O2")
+      opt_level = arg[2] - '0';
+    else if (arg.rfind("-", 0) == 0) {
+      cout << "usage: " << argv[0] << " [-O0|-O1|-O2] [file]" << endl;
+      exit(1);
+    }
+    else
+      file_name = arg;
+  }
+  SourceFile source(file_name);
+  if (file_name != "" and !source.is_open()) {
+    cout << "unable to open file '" << file_name << "'" << endl;
+    exit(1);
+  }
   //open output file
   ofstream out;
   out.open("test.cpp");
   // create the lexer
-  Lexer lexer(*input_stream);
+  Lexer lexer = file_name != "" ? Lexer(source.begin(), source.end())
+                                : Lexer(cin);
   Parser parser(lexer);
   // read each token in the file until EOS or error
   //Interpreter interpreter;
@@ -41,15 +61,14 @@ int main(int argc, char* argv[])
     parser.parse(ast_root_node);
     TypeChecker type_checker;
     ast_root_node.accept(type_checker);
+    Optimizer optimizer(opt_level);
+    ast_root_node.accept(optimizer);
     //ast_root_node.accept(interpreter);
     ast_root_node.accept(printer);
   } catch (MyPLException e) {
     cout << e.to_string() << endl;
     exit(1);
   }
-  // clean up the input stream
-  if (input_stream != &cin)
-    delete input_stream;
 
   //close output file
   out.close();
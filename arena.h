@@ -0,0 +1,110 @@
+//----------------------------------------------------------------------
+// NAME: Brennan Longstreth
+// FILE: arena.h
+// CONTRIBUTORS:
+// DATE: Fall 2026
+// DESC: Bump allocator for AST nodes. Objects are carved out of large
+//       blocks one after another (so nodes built together sit next to
+//       each other in memory) and are all destroyed and released at
+//       once when the arena is destroyed.
+// NOTES: Objects can't be freed individually. Destructors run in the
+//        reverse order of construction, and only for types that need
+//        one.
+//----------------------------------------------------------------------
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+class Arena
+{
+public:
+
+  Arena() = default;
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  // destroy every object and free the blocks
+  ~Arena();
+
+  // construct a T (with the given constructor arguments) in the arena
+  template<typename T, typename... Args>
+  T* make(Args&&... args);
+
+private:
+
+  // bytes per block (larger objects get a block of their own)
+  static const size_t BLOCK_SIZE = 64 * 1024;
+
+  // the allocated blocks, and the free space left in the last one
+  std::vector<char*> blocks;
+  char* next = nullptr;
+  size_t remaining = 0;
+
+  // objects that need their destructor run
+  struct Cleanup
+  {
+    void (*destroy)(void*);
+    void* obj;
+  };
+  std::vector<Cleanup> cleanups;
+
+  // get aligned, uninitialized storage
+  void* allocate(size_t size, size_t align);
+
+  template<typename T>
+  static void destroy(void* obj);
+};
+
+
+Arena::~Arena()
+{
+  for (size_t i = cleanups.size(); i > 0; --i)
+    cleanups[i-1].destroy(cleanups[i-1].obj);
+  for (char* block : blocks)
+    delete[] block;
+}
+
+
+void* Arena::allocate(size_t size, size_t align)
+{
+  size_t padding = (align - reinterpret_cast<size_t>(next) % align) % align;
+  if (padding + size > remaining) {
+    size_t block_size = std::max(size + align, (size_t)BLOCK_SIZE);
+    blocks.push_back(new char[block_size]);
+    next = blocks.back();
+    remaining = block_size;
+    padding = (align - reinterpret_cast<size_t>(next) % align) % align;
+  }
+  void* p = next + padding;
+  next += padding + size;
+  remaining -= padding + size;
+  return p;
+}
+
+
+template<typename T>
+void Arena::destroy(void* obj)
+{
+  static_cast<T*>(obj)->~T();
+}
+
+
+template<typename T, typename... Args>
+T* Arena::make(Args&&... args)
+{
+  void* p = allocate(sizeof(T), alignof(T));
+  T* obj = new (p) T(std::forward<Args>(args)...);
+  if (!std::is_trivially_destructible<T>::value)
+    cleanups.push_back(Cleanup{&destroy<T>, obj});
+  return obj;
+}
+
+
+#endif
@@ -5,15 +5,20 @@
 // DESC: AST types for MyPL implementation. Each AST node is
 //       implemented as POD (plain old data) types, with all data
 //       public, with the exception of the visitor abstraction (i.e.,
-//       the accept function) and a destrutor for dynamic memory. Note
-//       that some liberties are taken with formatting to keep the
-//       file size manageable.
+//       the accept function). Nodes are allocated from the Program's
+//       arena and are all freed with the Program. Note that some
+//       liberties are taken with formatting to keep the file size
+//       manageable.
 //----------------------------------------------------------------------
 
 #ifndef AST_H
 #define AST_H
 
-#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "arena.h"
+#include "kernels.h"
 
 //----------------------------------------------------------------------
 // Visitor interface
@@ -41,6 +46,23 @@ class IDRValue;
 class NegatedRValue;
 
 
+// the target of a call that isn't a user-defined function
+enum BuiltIn {USER_FUN, PRINT_FUN, ITOS_FUN, STOI_FUN, STOD_FUN, DTOS_FUN,
+              LENGTH_FUN, GET_FUN, READ_FUN};
+
+// the built-in with the given name (USER_FUN if there is none)
+BuiltIn built_in_named(const std::string& name)
+{
+  static const std::unordered_map<std::string,BuiltIn> built_ins = {
+    {"print", PRINT_FUN}, {"itos", ITOS_FUN}, {"stoi", STOI_FUN},
+    {"stod", STOD_FUN}, {"dtos", DTOS_FUN}, {"length", LENGTH_FUN},
+    {"get", GET_FUN}, {"read", READ_FUN}
+  };
+  auto it = built_ins.find(name);
+  return it == built_ins.end() ? USER_FUN : it->second;
+}
+
+
 class Visitor {
 public:
   // top-level
@@ -119,8 +141,13 @@ public:
   ExprTerm* first = nullptr;    // the first term
   Token* op = nullptr;          // optional operator
   Expr* rest = nullptr;         // expression after operator (if exists)
-  // cleanup
-  ~Expr() {delete first; delete op; delete rest;}
+  // set by the type checker when there is an operator
+  BinOp bin_op = BIN_NONE;                       // decoded operator
+  DataObject::DataType lhs_type = DataObject::NIL;  // static type of first
+  DataObject::DataType rhs_type = DataObject::NIL;  // static type of rest
+  Kernel kernel = nullptr;                       // evaluates the operator
+  // set by the type checker: static type of the whole expression
+  DataObject::DataType type = DataObject::NIL;
   // get first token
   Token first_token() {return first->first_token();}
   // visitor access
@@ -132,8 +159,6 @@ class SimpleTerm : public ExprTerm
 {
 public:
   RValue* rvalue = nullptr;     // one rvalue ("base case")
-  // cleanup memory
-  ~SimpleTerm() {delete rvalue;}
   // return first token
   Token first_token() {return rvalue->first_token();}  
   // visitor access
@@ -145,8 +170,6 @@ class ComplexTerm : public ExprTerm
 {
 public:
   Expr* expr = nullptr;         // term is another expression
-  // cleanup memory
-  ~ComplexTerm() {delete expr;}
   // return first token
   Token first_token() {return expr->first->first_token();}  
   // visitor access
@@ -162,9 +185,8 @@ public:
 class Program : public ASTNode
 {
 public:
-  std::list<Decl*> decls;       //  list of declarations
-  // cleanup memory
-  ~Program() {for (Decl* d : decls) delete d;}
+  std::vector<Decl*> decls;     //  list of declarations
+  Arena arena;                  //  storage for all of the nodes
   // visitor access
   void accept(Visitor& v) {v.visit(*this);}
 };
@@ -176,10 +198,10 @@ public:
   struct FunParam {Token id; Token type;}; // function parameter type
   Token return_type;                       // function return type
   Token id;                                // function name
-  std::list<FunParam> params;              // function params
-  std::list<Stmt*> stmts;                  // function body 
-  // cleanup memory
-  ~FunDecl() {for (Stmt* s : stmts) delete s;}
+  std::vector<FunParam> params;            // function params
+  std::vector<Stmt*> stmts;                // function body 
+  int frame_size = 0;                      // slots for params + locals
+  bool pure = false;                       // set by the purity checker
   // visitor access
   void accept(Visitor& v) {v.visit(*this);}
 };
@@ -191,8 +213,7 @@ public:
   Token* type = nullptr;        // optional variable type
   Token id;                     // variable name
   Expr* expr = nullptr;         // variable initialization expression
-  // cleanup memory
-  ~VarDeclStmt() {delete type; delete expr;}
+  int slot = 0;                 // slot in the function's frame
   // visitor access
   void accept(Visitor& v) {v.visit(*this);}
 };
@@ -201,10 +222,12 @@ public:
 class TypeDecl : public Decl
 {
 public:
-  Token id;                       // type name
-  std::list<VarDeclStmt*> vdecls; // variable declarations
-  // cleanup memory
-  ~TypeDecl() {for (VarDeclStmt* v : vdecls) delete v;}
+  Token id;                         // type name
+  std::vector<VarDeclStmt*> vdecls; // variable declarations
+  // set by the interpreter: field values of a new object, and the
+  // fields whose initializers aren't constant (evaluated per object)
+  std::vector<DataObject> prototype;
+  std::vector<size_t> computed_fields;
   // visitor access
   void accept(Visitor& v) {v.visit(*this);}
 };
@@ -218,10 +241,10 @@ public:
 class AssignStmt : public Stmt
 {
 public:
-  std::list<Token> lvalue_list; // lhs as one or more ids
-  Expr* expr = nullptr;         // rhs expression
-  // cleanup memory
-  ~AssignStmt() {delete expr;}
+  std::vector<Token> lvalue_list; // lhs as one or more ids
+  Expr* expr = nullptr;           // rhs expression
+  int slot = 0;                   // frame slot of the first id
+  std::vector<int> offsets;       // field offsets of the remaining ids
   // visitor access
   void accept(Visitor& v) {v.visit(*this);}
 };
@@ -231,8 +254,6 @@ class ReturnStmt : public Stmt
 {
 public:
   Expr* expr = nullptr;         // return expression
-  // cleanup memory
-  ~ReturnStmt() {delete expr;}
   // visitor access
   void accept(Visitor& v) {v.visit(*this);}
 };  
@@ -242,28 +263,17 @@ public:
 class BasicIf
 {
 public:
-  Expr* expr = nullptr;   // boolean expression
-  std::list<Stmt*> stmts; // body statements
-  // cleanup memory
-  ~BasicIf() {delete expr; for (Stmt* s : stmts) delete s;}
+  Expr* expr = nullptr;     // boolean expression
+  std::vector<Stmt*> stmts; // body statements
 };
 
 
 class IfStmt : public Stmt
 {
 public:
-  BasicIf* if_part = nullptr;   // if part
-  std::list<BasicIf*> else_ifs; // else ifs
-  std::list<Stmt*> body_stmts;  // else body (if empty, no else)
-  // cleanup memory
-  ~IfStmt()
-  {
-    delete if_part;
-    for (BasicIf* s : else_ifs)
-      delete s;
-    for (Stmt* s : body_stmts)
-      delete s;
-  }
+  BasicIf* if_part = nullptr;     // if part
+  std::vector<BasicIf*> else_ifs; // else ifs
+  std::vector<Stmt*> body_stmts;  // else body (if empty, no else)
   // visitor access
   void accept(Visitor& v) {v.visit(*this);}
 };  
@@ -273,9 +283,7 @@ class WhileStmt : public Stmt
 {
 public:
   Expr* expr = nullptr;         // boolean expression
-  std::list<Stmt*> stmts;       // body statements
-  // cleanup memory
-  ~WhileStmt() {delete expr; for (Stmt* s : stmts) delete s;}
+  std::vector<Stmt*> stmts;     // body statements
   // visitor access
   void accept(Visitor& v) {v.visit(*this);}
 };  
@@ -287,9 +295,8 @@ public:
   Token var_id;                 // loop variable
   Expr* start;                  // loop start expression
   Expr* end;                    // loop end expression
-  std::list<Stmt*> stmts;       // loop body
-  // cleanup memory
-  ~ForStmt() {delete start; delete end; for (Stmt* s : stmts) delete s;}
+  std::vector<Stmt*> stmts;     // loop body
+  int slot = 0;                 // frame slot of the loop variable
   // visitor access
   void accept(Visitor& v) {v.visit(*this);}
 };  
@@ -304,6 +311,7 @@ class SimpleRValue : public RValue
 {
 public:
   Token value;                  // primitive value
+  DataObject literal;           // decoded value (set by type checker)
   // return first token
   Token first_token() {return value;}  
   // visitor access
@@ -315,6 +323,7 @@ class NewRValue : public RValue
 {
 public:
   Token type_id;                // type name being instantiated
+  TypeDecl* type = nullptr;     // the type (set by the resolver)
   // return first token
   Token first_token() {return type_id;}  
   // visitor access
@@ -326,9 +335,11 @@ class CallExpr : public RValue, public Stmt
 {
 public:
   Token function_id;            // function name being called
-  std::list<Expr*> arg_list;    // call arguments
-  // cleanup memory
-  ~CallExpr() {for(Expr* e : arg_list) delete e;}
+  std::vector<Expr*> arg_list;  // call arguments
+  // set by the resolver: the built-in called, or USER_FUN and fun
+  BuiltIn built_in = USER_FUN;
+  FunDecl* fun = nullptr;
+  bool tail_call = false;       // nothing runs after it in its function
   // return first token
   Token first_token() {return function_id;}  
   // visitor access
@@ -339,7 +350,9 @@ public:
 class IDRValue : public RValue
 {
 public:
-  std::list<Token> path;        // one or more ids (path expression)
+  std::vector<Token> path;      // one or more ids (path expression)
+  int slot = 0;                 // frame slot of the first id
+  std::vector<int> offsets;     // field offsets of the remaining ids
   // return first token
   Token first_token() {return path.front();}  
   // visitor access
@@ -351,8 +364,6 @@ class NegatedRValue : public RValue
 {
 public:
   Expr* expr = nullptr;         // negated expression
-  // cleanup memory
-  ~NegatedRValue() {delete expr;}
   // return first token
   Token first_token() {return expr->first->first_token();}  
   // visitor access
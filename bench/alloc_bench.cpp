@@ -0,0 +1,114 @@
+//----------------------------------------------------------------------
+// NAME: Brennan Longstreth
+// FILE: alloc_bench.cpp
+// CONTRIBUTORS:
+// DATE: Fall 2026
+// DESC: Counts heap allocations per DataObject operation. Each
+//       arithmetic op reads two operands, sets a result, and copies
+//       and moves it the way the interpreter passes values around.
+//       Scalar ops must not allocate, so the program fails (exit 1)
+//       if any of them do.
+// NOTES: usage: alloc_bench [iterations] (default 1000000). Only the
+//        DataObject set/value/copy API is used, so the same source
+//        also builds against older versions of data_object.h.
+//----------------------------------------------------------------------
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <utility>
+#include "../data_object.h"
+
+using namespace std;
+
+
+// every allocation in the program goes through these
+static size_t allocations = 0;
+
+void* operator new(size_t size)
+{
+  ++allocations;
+  void* p = malloc(size ? size : 1);
+  if (!p)
+    throw bad_alloc();
+  return p;
+}
+
+void operator delete(void* p) noexcept
+{
+  free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+  free(p);
+}
+
+
+// run op n times and print its allocations and time per op
+template<typename Op>
+double measure(const string& name, size_t n, Op op)
+{
+  size_t before = allocations;
+  auto start = chrono::steady_clock::now();
+  for (size_t i = 0; i < n; ++i)
+    op(i);
+  chrono::duration<double,nano> took = chrono::steady_clock::now() - start;
+  double per_op = double(allocations - before) / n;
+  cout << "  " << name << ": " << per_op << " allocations/op, "
+       << took.count() / n << " ns/op" << endl;
+  return per_op;
+}
+
+
+int main(int argc, char* argv[])
+{
+  size_t n = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000000;
+  DataObject lhs(7), rhs(3), result, copy;
+  DataObject dlhs(7.5), drhs(0.5);
+  DataObject clhs('a'), crhs('b');
+  DataObject slhs(string("shared string")), scopy;
+  double total = 0;
+  cout << "DataObject (" << n << " iterations)" << endl;
+  // int arithmetic: read both operands, set the result, copy and move
+  total += measure("int add", n, [&](size_t i) {
+    int l, r;
+    lhs.value(l);
+    rhs.value(r);
+    result.set(l + r + int(i & 1));
+    copy = result;
+    DataObject moved(std::move(copy));
+    result = std::move(moved);
+  });
+  total += measure("double mul", n, [&](size_t) {
+    double l, r;
+    dlhs.value(l);
+    drhs.value(r);
+    result.set(l * r);
+    copy = result;
+    DataObject moved(std::move(copy));
+    result = std::move(moved);
+  });
+  total += measure("char compare", n, [&](size_t) {
+    char l, r;
+    clhs.value(l);
+    crhs.value(r);
+    result.set(l < r);
+    copy = result;
+    DataObject moved(std::move(copy));
+    result = std::move(moved);
+  });
+  // strings are shared between copies, so copying one is free too
+  total += measure("string copy", n, [&](size_t) {
+    scopy = slhs;
+    DataObject moved(std::move(scopy));
+    scopy = std::move(moved);
+  });
+  if (total > 0) {
+    cout << "FAILED: DataObject operations allocate" << endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,241 @@
+//----------------------------------------------------------------------
+// NAME: Brennan Longstreth
+// FILE: ast_bench.cpp
+// CONTRIBUTORS:
+// DATE: Fall 2026
+// DESC: Generates a large MyPL program, parses it, and reports the
+//       heap the AST keeps alive and how fast a visitor can walk every
+//       statement and expression in it. With --emit the generated
+//       program is written to standard output instead (e.g., to time
+//       mypl on it).
+// NOTES: usage: ast_bench [--emit] [functions] [walks] (defaults 500
+//        and 200). Each function is about 20 lines. Only the AST
+//        fields and the range-for loops over its child sequences are
+//        used, so the same source builds against older versions of
+//        the AST (e.g., before its sequences became vectors).
+//----------------------------------------------------------------------
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include "../lexer.h"
+#include "../parser.h"
+#include "../ast.h"
+
+using namespace std;
+
+
+// live heap bytes, tracked through a size header on each allocation
+static size_t live_bytes = 0;
+static const size_t HEADER = 16;
+
+void* operator new(size_t size)
+{
+  char* p = static_cast<char*>(malloc(size + HEADER));
+  if (!p)
+    throw bad_alloc();
+  *reinterpret_cast<size_t*>(p) = size;
+  live_bytes += size;
+  return p + HEADER;
+}
+
+void operator delete(void* p) noexcept
+{
+  if (!p)
+    return;
+  char* block = static_cast<char*>(p) - HEADER;
+  live_bytes -= *reinterpret_cast<size_t*>(block);
+  free(block);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+  operator delete(p);
+}
+
+
+// the generated program: a type, n functions that loop over a mix of
+// statements, and a main that calls each of them
+string generate(int n)
+{
+  ostringstream out;
+  out << "type Point\n  var x = 0\n  var y = 0\nend\n\n";
+  for (int i = 0; i < n; ++i) {
+    out << "fun int f" << i << "(a: int, b: int, p: Point)\n"
+        << "  var total = 0\n"
+        << "  var k = 0\n"
+        << "  while k < b do\n"
+        << "    if k < a then\n"
+        << "      total = total + (k * " << i % 7 + 1 << ")\n"
+        << "    elseif k == a then\n"
+        << "      p.x = p.x + 1\n"
+        << "    else\n"
+        << "      total = total - 1\n"
+        << "    end\n"
+        << "    p.y = p.y + k\n"
+        << "    k = k + 1\n"
+        << "  end\n"
+        << "  for j = 1 to 3 do\n"
+        << "    total = total + (j * p.x)\n"
+        << "  end\n"
+        << "  return total\n"
+        << "end\n\n";
+  }
+  out << "fun int main()\n"
+      << "  var p = new Point\n"
+      << "  var sum = 0\n"
+      << "  for r = 1 to 20 do\n";
+  for (int i = 0; i < n; ++i)
+    out << "    sum = sum + f" << i << "(r, 10, p)\n";
+  out << "  end\n"
+      << "  print(itos(sum) + \"\\n\")\n"
+      << "  return 0\n"
+      << "end\n";
+  return out.str();
+}
+
+
+// visits every node reachable from the program, counting them
+class NodeCounter : public Visitor
+{
+public:
+  size_t count = 0;
+  void visit(Program& node) {
+    ++count;
+    for (Decl* d : node.decls)
+      d->accept(*this);
+  }
+  void visit(FunDecl& node) {
+    count += 1 + node.params.size();
+    block(node.stmts);
+  }
+  void visit(TypeDecl& node) {
+    ++count;
+    for (VarDeclStmt* v : node.vdecls)
+      v->accept(*this);
+  }
+  void visit(VarDeclStmt& node) {
+    ++count;
+    node.expr->accept(*this);
+  }
+  void visit(AssignStmt& node) {
+    count += node.lvalue_list.size();
+    node.expr->accept(*this);
+  }
+  void visit(ReturnStmt& node) {
+    ++count;
+    node.expr->accept(*this);
+  }
+  void visit(IfStmt& node) {
+    ++count;
+    node.if_part->expr->accept(*this);
+    block(node.if_part->stmts);
+    for (BasicIf* b : node.else_ifs) {
+      b->expr->accept(*this);
+      block(b->stmts);
+    }
+    block(node.body_stmts);
+  }
+  void visit(WhileStmt& node) {
+    ++count;
+    node.expr->accept(*this);
+    block(node.stmts);
+  }
+  void visit(ForStmt& node) {
+    ++count;
+    node.start->accept(*this);
+    node.end->accept(*this);
+    block(node.stmts);
+  }
+  void visit(Expr& node) {
+    ++count;
+    node.first->accept(*this);
+    if (node.rest)
+      node.rest->accept(*this);
+  }
+  void visit(SimpleTerm& node) {
+    ++count;
+    node.rvalue->accept(*this);
+  }
+  void visit(ComplexTerm& node) {
+    ++count;
+    node.expr->accept(*this);
+  }
+  void visit(SimpleRValue&) {
+    ++count;
+  }
+  void visit(NewRValue&) {
+    ++count;
+  }
+  void visit(CallExpr& node) {
+    ++count;
+    for (Expr* e : node.arg_list)
+      e->accept(*this);
+  }
+  void visit(IDRValue& node) {
+    count += node.path.size();
+  }
+  void visit(NegatedRValue& node) {
+    ++count;
+    node.expr->accept(*this);
+  }
+private:
+  template<typename Seq>
+  void block(Seq& stmts) {
+    for (Stmt* s : stmts)
+      s->accept(*this);
+  }
+};
+
+
+int main(int argc, char* argv[])
+{
+  bool emit = false;
+  int functions = 500;
+  int walks = 200;
+  int positional = 0;
+  for (int i = 1; i < argc; ++i) {
+    string arg = argv[i];
+    if (arg == "--emit")
+      emit = true;
+    else if (positional++ == 0)
+      functions = atoi(argv[i]);
+    else
+      walks = atoi(argv[i]);
+  }
+  string source = generate(functions);
+  if (emit) {
+    cout << source;
+    return 0;
+  }
+  size_t lines = 0;
+  for (char c : source)
+    lines += c == '\n';
+  istringstream input(source);
+  Lexer lexer(input);
+  Parser parser(lexer);
+  Program* program = new Program;
+  size_t before = live_bytes;
+  auto start = chrono::steady_clock::now();
+  parser.parse(*program);
+  chrono::duration<double,milli> parse_ms = chrono::steady_clock::now() - start;
+  size_t ast_bytes = live_bytes - before;
+  NodeCounter counter;
+  start = chrono::steady_clock::now();
+  for (int i = 0; i < walks; ++i)
+    program->accept(counter);
+  chrono::duration<double,milli> walk_ms = chrono::steady_clock::now() - start;
+  size_t nodes = counter.count / walks;
+  cout << "AST (" << functions << " functions, " << lines << " lines)" << endl
+       << "  parse: " << parse_ms.count() << " ms" << endl
+       << "  size: " << ast_bytes << " bytes for " << nodes << " nodes ("
+       << double(ast_bytes) / nodes << " bytes/node)" << endl
+       << "  walk: " << walk_ms.count() / walks << " ms per walk ("
+       << walk_ms.count() * 1e6 / (double(walks) * nodes) << " ns/node)"
+       << endl;
+  delete program;
+  return 0;
+}
@@ -0,0 +1,66 @@
+//----------------------------------------------------------------------
+// NAME: Brennan Longstreth
+// FILE: lexer_bench.cpp
+// CONTRIBUTORS:
+// DATE: Fall 2026
+// DESC: Times Lexer::next_token on generated identifier-heavy input:
+//       identifiers that share first letters and lengths with the
+//       reserved words (e.g., "form", "done", "tofu"), mixed with
+//       the reserved words themselves.
+// NOTES: usage: lexer_bench [tokens] [runs] (defaults 1000000 and 5).
+//        The best run is reported. Only the Lexer(begin, end)
+//        constructor and next_token are used, so the same source
+//        builds against older versions of the lexer.
+//----------------------------------------------------------------------
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "../lexer.h"
+
+using namespace std;
+
+
+int main(int argc, char* argv[])
+{
+  size_t tokens = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000000;
+  int runs = argc > 2 ? atoi(argv[2]) : 5;
+  // 19 identifiers and 13 reserved words
+  const char* words[] = {
+    "form", "done", "tofu", "value", "nilly", "iffy", "thenar", "ending",
+    "fund", "types", "variable", "whiles", "and", "for", "fun", "if",
+    "int", "new", "nil", "then", "end", "var", "while", "to", "total",
+    "newer", "string_of", "bool2", "charm", "double_it", "returned",
+    "return"
+  };
+  size_t word_count = sizeof(words) / sizeof(words[0]);
+  string source;
+  for (size_t i = 0; i < tokens; ++i) {
+    source += words[(i * 7) % word_count];
+    source += i % 12 == 11 ? '\n' : ' ';
+  }
+  double best = 0;
+  size_t ids = 0, keywords = 0;
+  for (int run = 0; run < runs; ++run) {
+    ids = keywords = 0;
+    auto start = chrono::steady_clock::now();
+    Lexer lexer(source.data(), source.data() + source.size());
+    Token t = lexer.next_token();
+    while (t.type() != EOS) {
+      if (t.type() == ID)
+        ++ids;
+      else
+        ++keywords;
+      t = lexer.next_token();
+    }
+    chrono::duration<double,milli> took = chrono::steady_clock::now() - start;
+    if (run == 0 or took.count() < best)
+      best = took.count();
+  }
+  cout << "Lexer (" << ids << " identifiers, " << keywords
+       << " reserved words, best of " << runs << ")" << endl
+       << "  " << best << " ms, " << best * 1e6 / (ids + keywords)
+       << " ns/token" << endl;
+  return 0;
+}
@@ -0,0 +1,842 @@
+//----------------------------------------------------------------------
+// NAME: Brennan Longstreth
+// FILE: bytecode.h
+// CONTRIBUTORS:
+// DATE: Fall 2026
+// DESC: Register-based bytecode for MyPL and the compiler that lowers
+//       a type-checked AST into it. Every function gets a fixed-size
+//       window of registers with its parameters in the first slots.
+//       Call arguments are evaluated into consecutive registers at
+//       the top of the caller's window, so the callee's window starts
+//       right on top of them and nothing has to be copied.
+// NOTES: Operand types come from the type checker's annotations on
+//        each Expr, so each arithmetic and comparison instruction
+//        only handles one pair of types at run time.
+//----------------------------------------------------------------------
+
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "ast.h"
+#include "data_object.h"
+#include "mypl_exception.h"
+
+
+// instruction set (R = registers of the current frame, K = constants)
+enum OpCode {
+  // loads and moves
+  OP_LOADK,             // R[a] = K[b]
+  OP_LOADNIL,           // R[a] = nil
+  OP_MOVE,              // R[a] = R[b]
+  // int arithmetic: R[a] = R[b] op R[c]
+  OP_ADD_I, OP_SUB_I, OP_MUL_I, OP_DIV_I, OP_MOD_I,
+  // double arithmetic: R[a] = R[b] op R[c]
+  OP_ADD_D, OP_SUB_D, OP_MUL_D, OP_DIV_D,
+  // string/char concatenation: R[a] = R[b] + R[c]
+  OP_CONCAT,
+  // relational operators: R[a] = R[b] op R[c]
+  OP_LT_I, OP_LE_I, OP_GT_I, OP_GE_I,
+  OP_LT_D, OP_LE_D, OP_GT_D, OP_GE_D,
+  OP_LT_S, OP_LE_S, OP_GT_S, OP_GE_S,
+  OP_LT_C, OP_LE_C, OP_GT_C, OP_GE_C,
+  // equality (any types, including nil and oids): R[a] = R[b] op R[c]
+  OP_EQ, OP_NE,
+  // boolean operators: R[a] = R[b] op R[c]
+  OP_AND, OP_OR,
+  // unary operators: R[a] = op R[b]
+  OP_NOT, OP_NEG_I, OP_NEG_D,
+  // control flow
+  OP_JMP,               // pc = a
+  OP_JMPF,              // if not R[a] then pc = b
+  OP_JMPAND,            // if not R[b] then R[a] = R[b]; pc = c
+  OP_JMPOR,             // if R[b] then R[a] = R[b]; pc = c
+  OP_FORBOUND,          // error if R[a] is nil (b: 0 start, 1 end)
+  OP_FORTEST,           // if R[a] > R[b] then pc = c
+  OP_FORSTEP,           // R[a] = R[a] + 1; pc = b (unless at INT_MAX)
+  // calls: callee window starts at R[b], result goes to R[c]
+  OP_CALL,              // call function a
+  OP_RET,               // return R[a]
+  OP_RETNIL,            // return nil
+  // user-defined type objects
+  OP_NEW,               // R[a] = new object of type b
+  OP_GETF,              // R[a] = R[b].fields[c]
+  OP_SETF,              // R[a].fields[b] = R[c]
+  // built-in functions: R[a] = f(R[b], ...)
+  OP_PRINT, OP_ITOS, OP_DTOS, OP_STOI, OP_STOD, OP_LENGTH, OP_GET,
+  OP_READ
+};
+
+
+// a single instruction
+struct Instr
+{
+  OpCode op;
+  int a;
+  int b;
+  int c;
+};
+
+
+// a compiled function
+struct BytecodeFunction
+{
+  std::string name;
+  int param_count = 0;
+  int register_count = 0;
+  std::vector<Instr> code;
+  // source line and column of each instruction (for runtime errors)
+  std::vector<std::pair<int,int>> positions;
+};
+
+
+// field layout of a user-defined type
+struct TypeLayout
+{
+  std::string name;
+  std::vector<std::string> fields;
+  std::vector<std::string> field_types;
+};
+
+
+// a compiled program
+struct BytecodeProgram
+{
+  std::vector<BytecodeFunction> functions;
+  std::vector<TypeLayout> types;
+  std::vector<DataObject> constants;
+  int main_index = -1;
+};
+
+
+class BytecodeCompiler : public Visitor
+{
+public:
+
+  // compile into the given (empty) program
+  BytecodeCompiler(BytecodeProgram& program);
+
+  // top-level
+  void visit(Program& node);
+  void visit(FunDecl& node);
+  void visit(TypeDecl& node);
+  // statements
+  void visit(VarDeclStmt& node);
+  void visit(AssignStmt& node);
+  void visit(ReturnStmt& node);
+  void visit(IfStmt& node);
+  void visit(WhileStmt& node);
+  void visit(ForStmt& node);
+  // expressions
+  void visit(Expr& node);
+  void visit(SimpleTerm& node);
+  void visit(ComplexTerm& node);
+  // rvalues
+  void visit(SimpleRValue& node);
+  void visit(NewRValue& node);
+  void visit(CallExpr& node);
+  void visit(IDRValue& node);
+  void visit(NegatedRValue& node);
+
+private:
+
+  // a variable bound to a register of the current function
+  struct Local {int reg; std::string type;};
+  typedef std::unordered_map<std::string,Local> Scope;
+
+  BytecodeProgram& prog;
+
+  // function currently being compiled
+  BytecodeFunction* fun = nullptr;
+
+  // block scopes of the current function (innermost last)
+  std::vector<Scope> scopes;
+
+  // first free register of the current function
+  int next_reg = 0;
+
+  // register the next expression or rvalue is written to
+  int dest = 0;
+
+  // static type of the most recently compiled expression
+  std::string curr_type;
+
+  // position of the most recently compiled token (for error info)
+  int line = 0;
+  int column = 0;
+
+  // function (by declaration), type and string-constant indexes
+  std::unordered_map<FunDecl*,int> fun_index;
+  std::unordered_map<std::string,int> type_index;
+  std::unordered_map<std::string,int> string_consts;
+
+  // type declarations (for compiling field initializers)
+  std::unordered_map<std::string,TypeDecl*> type_decls;
+
+  // types whose field initializers are currently being compiled
+  std::vector<std::string> init_types;
+
+  // helpers
+  int alloc_reg();
+  int emit(OpCode op, int a = 0, int b = 0, int c = 0);
+  void patch(int at, int target);
+  int here() const;
+  int constant(const DataObject& val);
+  int string_constant(const std::string& val);
+  Local* lookup(const std::string& name);
+  void declare(const std::string& name, int reg, const std::string& type);
+  int field_index(const std::string& type, const Token& field);
+  void set_position(const Token& token);
+  void compile_expr(Expr& node, int reg);
+  int operand(Expr& node);
+  void compile_stmt(Stmt* stmt);
+  void compile_block(std::vector<Stmt*>& stmts);
+  void binary_op(Expr& node, int reg, int l, int r);
+  void negate(DataObject::DataType type, int reg);
+  void error(const std::string& msg, const Token& token);
+};
+
+
+//----------------------------------------------------------------------
+// HELPER FUNCTIONS
+//----------------------------------------------------------------------
+
+BytecodeCompiler::BytecodeCompiler(BytecodeProgram& program)
+  : prog(program)
+{
+}
+
+
+void BytecodeCompiler::error(const std::string& msg, const Token& token)
+{
+  throw MyPLException(SEMANTIC, msg, token.line(), token.column());
+}
+
+
+int BytecodeCompiler::alloc_reg()
+{
+  int reg = next_reg++;
+  if (next_reg > fun->register_count)
+    fun->register_count = next_reg;
+  return reg;
+}
+
+
+int BytecodeCompiler::emit(OpCode op, int a, int b, int c)
+{
+  fun->code.push_back(Instr{op, a, b, c});
+  fun->positions.push_back(std::pair<int,int>(line, column));
+  return fun->code.size() - 1;
+}
+
+
+// set the jump target of a previously emitted jump
+void BytecodeCompiler::patch(int at, int target)
+{
+  Instr& instr = fun->code[at];
+  if (instr.op == OP_JMP)
+    instr.a = target;
+  else if (instr.op == OP_JMPF)
+    instr.b = target;
+  else
+    instr.c = target;
+}
+
+
+int BytecodeCompiler::here() const
+{
+  return fun->code.size();
+}
+
+
+int BytecodeCompiler::constant(const DataObject& val)
+{
+  prog.constants.push_back(val);
+  return prog.constants.size() - 1;
+}
+
+
+// strings are shared so repeated literals take a single constant slot
+int BytecodeCompiler::string_constant(const std::string& val)
+{
+  auto it = string_consts.find(val);
+  if (it != string_consts.end())
+    return it->second;
+  int index = constant(DataObject(val));
+  string_consts[val] = index;
+  return index;
+}
+
+
+BytecodeCompiler::Local* BytecodeCompiler::lookup(const std::string& name)
+{
+  for (size_t i = scopes.size(); i > 0; --i) {
+    auto it = scopes[i-1].find(name);
+    if (it != scopes[i-1].end())
+      return &it->second;
+  }
+  return nullptr;
+}
+
+
+void BytecodeCompiler::declare(const std::string& name, int reg,
+                               const std::string& type)
+{
+  scopes.back()[name] = Local{reg, type};
+}
+
+
+int BytecodeCompiler::field_index(const std::string& type, const Token& field)
+{
+  auto it = type_index.find(type);
+  if (it == type_index.end())
+    error("'" + type + "' is not a user-defined type", field);
+  const TypeLayout& layout = prog.types[it->second];
+  for (size_t i = 0; i < layout.fields.size(); ++i)
+    if (layout.fields[i] == field.lexeme())
+      return i;
+  error("type '" + type + "' has no field '" + field.lexeme() + "'", field);
+  return -1;
+}
+
+
+void BytecodeCompiler::set_position(const Token& token)
+{
+  line = token.line();
+  column = token.column();
+}
+
+
+void BytecodeCompiler::compile_stmt(Stmt* stmt)
+{
+  // a call used as a statement still produces a value, so give it a
+  // scratch register instead of whatever dest was last set to
+  if (dynamic_cast<CallExpr*>(stmt)) {
+    int mark = next_reg;
+    dest = alloc_reg();
+    stmt->accept(*this);
+    next_reg = mark;
+  }
+  else
+    stmt->accept(*this);
+}
+
+
+// compile a list of statements in a new block scope, releasing the
+// block's registers at the end
+void BytecodeCompiler::compile_block(std::vector<Stmt*>& stmts)
+{
+  int mark = next_reg;
+  scopes.push_back(Scope());
+  for (Stmt* s : stmts)
+    compile_stmt(s);
+  scopes.pop_back();
+  next_reg = mark;
+}
+
+
+// compile the expression into the given register
+void BytecodeCompiler::compile_expr(Expr& node, int reg)
+{
+  if (!node.op) {
+    dest = reg;
+    node.first->accept(*this);
+  }
+  else {
+    int mark = next_reg;
+    int l;
+    // the first term is used in place when it is a plain variable
+    SimpleTerm* term = dynamic_cast<SimpleTerm*>(node.first);
+    IDRValue* id = term ? dynamic_cast<IDRValue*>(term->rvalue) : nullptr;
+    Local* local = (id and id->path.size() == 1) ?
+      lookup(id->path.front().lexeme()) : nullptr;
+    if (local) {
+      l = local->reg;
+      curr_type = local->type;
+    }
+    else {
+      l = alloc_reg();
+      dest = l;
+      node.first->accept(*this);
+    }
+    // operator errors are reported at the rest's first token, as in
+    // the tree interpreter
+    Token at = node.rest->first_token();
+    // and/or skip the rest when the first term decides the result
+    int skip = -1;
+    set_position(at);
+    if (node.op->type() == AND or node.op->type() == OR)
+      skip = emit(node.op->type() == AND ? OP_JMPAND : OP_JMPOR, reg, l);
+    int r = operand(*node.rest);
+    set_position(at);
+    binary_op(node, reg, l, r);
+    if (skip >= 0)
+      patch(skip, here());
+    next_reg = mark;
+  }
+  if (node.negated) {
+    set_position(node.first_token());
+    negate(node.type, reg);
+  }
+}
+
+
+// return a register holding the value of the expression, which is
+// the variable's own register for a plain variable and a new
+// temporary otherwise
+int BytecodeCompiler::operand(Expr& node)
+{
+  if (!node.op and !node.negated) {
+    SimpleTerm* term = dynamic_cast<SimpleTerm*>(node.first);
+    IDRValue* id = term ? dynamic_cast<IDRValue*>(term->rvalue) : nullptr;
+    if (id and id->path.size() == 1) {
+      Local* local = lookup(id->path.front().lexeme());
+      if (local) {
+        curr_type = local->type;
+        return local->reg;
+      }
+    }
+  }
+  int reg = alloc_reg();
+  compile_expr(node, reg);
+  return reg;
+}
+
+
+// emit the instruction for R[reg] = R[l] op R[r] from the operator and
+// operand types the type checker recorded, and set curr_type to the
+// result type
+void BytecodeCompiler::binary_op(Expr& node, int reg, int l, int r)
+{
+  BinOp op = node.bin_op;
+  DataObject::DataType lhs = node.lhs_type;
+  DataObject::DataType rhs = node.rhs_type;
+  bool is_text = (lhs == DataObject::STRING or lhs == DataObject::CHAR) and
+    (rhs == DataObject::STRING or rhs == DataObject::CHAR);
+  if (op == BIN_EQ or op == BIN_NE) {
+    emit(op == BIN_EQ ? OP_EQ : OP_NE, reg, l, r);
+    curr_type = "bool";
+  }
+  else if (op == BIN_AND or op == BIN_OR) {
+    emit(op == BIN_AND ? OP_AND : OP_OR, reg, l, r);
+    curr_type = "bool";
+  }
+  else if (op == BIN_ADD and is_text) {
+    emit(OP_CONCAT, reg, l, r);
+    curr_type = "string";
+  }
+  else if (op >= BIN_ADD and op <= BIN_MOD and lhs == rhs and
+           lhs == DataObject::INTEGER) {
+    OpCode ops[] = {OP_ADD_I, OP_SUB_I, OP_MUL_I, OP_DIV_I, OP_MOD_I};
+    emit(ops[op - BIN_ADD], reg, l, r);
+    curr_type = "int";
+  }
+  else if (op >= BIN_ADD and op <= BIN_DIV and lhs == rhs and
+           lhs == DataObject::DOUBLE) {
+    OpCode ops[] = {OP_ADD_D, OP_SUB_D, OP_MUL_D, OP_DIV_D};
+    emit(ops[op - BIN_ADD], reg, l, r);
+    curr_type = "double";
+  }
+  else if (op >= BIN_LT and op <= BIN_GE and lhs == rhs and
+           lhs != DataObject::BOOL and lhs != DataObject::OID and
+           lhs != DataObject::NIL) {
+    // relational operators (LT, LE, GT, GE are in the same order in
+    // both enums)
+    OpCode first[] = {OP_LT_I, OP_LT_D, OP_LT_S, OP_LT_C};  // by DataType
+    emit(OpCode(first[lhs] + (op - BIN_LT)), reg, l, r);
+    curr_type = "bool";
+  }
+  else
+    error("Illegal operator '" + node.op->lexeme() + "'", *node.op);
+}
+
+
+// emit the instruction for R[reg] = not/neg R[reg]
+void BytecodeCompiler::negate(DataObject::DataType type, int reg)
+{
+  if (type == DataObject::BOOL)
+    emit(OP_NOT, reg, reg);
+  else if (type == DataObject::INTEGER)
+    emit(OP_NEG_I, reg, reg);
+  else if (type == DataObject::DOUBLE)
+    emit(OP_NEG_D, reg, reg);
+}
+
+
+//----------------------------------------------------------------------
+// TOP-LEVEL
+//----------------------------------------------------------------------
+
+void BytecodeCompiler::visit(Program& node)
+{
+  // first pass: number the types and functions so that calls and
+  // allocations can refer to declarations further down the file
+  for (Decl* d : node.decls) {
+    if (TypeDecl* td = dynamic_cast<TypeDecl*>(d)) {
+      if (type_index.count(td->id.lexeme()))
+        continue;
+      TypeLayout layout;
+      layout.name = td->id.lexeme();
+      for (VarDeclStmt* v : td->vdecls) {
+        layout.fields.push_back(v->id.lexeme());
+        layout.field_types.push_back(v->type ? v->type->lexeme() : "nil");
+      }
+      type_index[layout.name] = prog.types.size();
+      type_decls[layout.name] = td;
+      prog.types.push_back(layout);
+    }
+    else if (FunDecl* fd = dynamic_cast<FunDecl*>(d)) {
+      BytecodeFunction f;
+      f.name = fd->id.lexeme();
+      f.param_count = fd->params.size();
+      // the last main is run, as in the tree interpreter
+      if (f.name == "main")
+        prog.main_index = prog.functions.size();
+      fun_index[fd] = prog.functions.size();
+      prog.functions.push_back(f);
+    }
+  }
+  if (prog.main_index < 0)
+    throw MyPLException(SEMANTIC, "undefined 'main' function");
+  // second pass: compile the function bodies
+  for (Decl* d : node.decls)
+    d->accept(*this);
+}
+
+
+void BytecodeCompiler::visit(FunDecl& node)
+{
+  fun = &prog.functions[fun_index[&node]];
+  next_reg = 0;
+  scopes.clear();
+  scopes.push_back(Scope());
+  for (FunDecl::FunParam& p : node.params)
+    declare(p.id.lexeme(), alloc_reg(), p.type.lexeme());
+  for (Stmt* s : node.stmts)
+    compile_stmt(s);
+  set_position(node.id);
+  emit(OP_RETNIL);
+  scopes.clear();
+  fun = nullptr;
+}
+
+
+void BytecodeCompiler::visit(TypeDecl&)
+{
+  // layouts are built in the first pass over the program
+}
+
+
+//----------------------------------------------------------------------
+// STATEMENTS
+//----------------------------------------------------------------------
+
+void BytecodeCompiler::visit(VarDeclStmt& node)
+{
+  int reg = alloc_reg();
+  compile_expr(*node.expr, reg);
+  std::string type = node.type ? node.type->lexeme() : curr_type;
+  if (type == "nil")
+    type = curr_type;
+  declare(node.id.lexeme(), reg, type);
+}
+
+
+void BytecodeCompiler::visit(AssignStmt& node)
+{
+  int mark = next_reg;
+  const Token& head = node.lvalue_list.front();
+  Local* local = lookup(head.lexeme());
+  if (!local)
+    error("undefined variable '" + head.lexeme() + "'", head);
+  if (node.lvalue_list.size() == 1) {
+    compile_expr(*node.expr, local->reg);
+    // variables initialized to nil take the type of their first value
+    if (local->type == "nil")
+      local->type = curr_type;
+  }
+  else {
+    int val = operand(*node.expr);
+    int obj = local->reg;
+    std::string type = local->type;
+    auto it = node.lvalue_list.begin();
+    auto last = --node.lvalue_list.end();
+    // a nil object is reported at the id naming it, as in the tree
+    // interpreter
+    for (++it; it != last; ++it) {
+      int field = field_index(type, *it);
+      type = prog.types[type_index[type]].field_types[field];
+      int tmp = alloc_reg();
+      set_position(*(it - 1));
+      emit(OP_GETF, tmp, obj, field);
+      obj = tmp;
+    }
+    int field = field_index(type, *last);
+    set_position(*(last - 1));
+    emit(OP_SETF, obj, field, val);
+  }
+  next_reg = mark;
+}
+
+
+void BytecodeCompiler::visit(ReturnStmt& node)
+{
+  int mark = next_reg;
+  int reg = operand(*node.expr);
+  emit(OP_RET, reg);
+  next_reg = mark;
+}
+
+
+void BytecodeCompiler::visit(IfStmt& node)
+{
+  std::vector<int> exits;
+  int mark = next_reg;
+  int cond = operand(*node.if_part->expr);
+  next_reg = mark;
+  int skip = emit(OP_JMPF, cond);
+  compile_block(node.if_part->stmts);
+  for (BasicIf* bi : node.else_ifs) {
+    exits.push_back(emit(OP_JMP));
+    patch(skip, here());
+    cond = operand(*bi->expr);
+    next_reg = mark;
+    skip = emit(OP_JMPF, cond);
+    compile_block(bi->stmts);
+  }
+  if (node.body_stmts.size() > 0) {
+    exits.push_back(emit(OP_JMP));
+    patch(skip, here());
+    compile_block(node.body_stmts);
+  }
+  else
+    patch(skip, here());
+  for (int at : exits)
+    patch(at, here());
+}
+
+
+void BytecodeCompiler::visit(WhileStmt& node)
+{
+  int top = here();
+  int mark = next_reg;
+  int cond = operand(*node.expr);
+  next_reg = mark;
+  int exit = emit(OP_JMPF, cond);
+  compile_block(node.stmts);
+  emit(OP_JMP, top);
+  patch(exit, here());
+}
+
+
+void BytecodeCompiler::visit(ForStmt& node)
+{
+  int mark = next_reg;
+  scopes.push_back(Scope());
+  // the loop variable and the end value (evaluated and checked once)
+  int var = alloc_reg();
+  compile_expr(*node.start, var);
+  set_position(node.start->first_token());
+  emit(OP_FORBOUND, var, 0);
+  int end = alloc_reg();
+  compile_expr(*node.end, end);
+  set_position(node.end->first_token());
+  emit(OP_FORBOUND, end, 1);
+  declare(node.var_id.lexeme(), var, "int");
+  set_position(node.var_id);
+  int top = emit(OP_FORTEST, var, end);
+  compile_block(node.stmts);
+  emit(OP_FORSTEP, var, top);
+  patch(top, here());
+  scopes.pop_back();
+  next_reg = mark;
+}
+
+
+//----------------------------------------------------------------------
+// EXPRESSIONS
+//----------------------------------------------------------------------
+
+void BytecodeCompiler::visit(Expr& node)
+{
+  compile_expr(node, dest);
+}
+
+
+void BytecodeCompiler::visit(SimpleTerm& node)
+{
+  node.rvalue->accept(*this);
+}
+
+
+void BytecodeCompiler::visit(ComplexTerm& node)
+{
+  compile_expr(*node.expr, dest);
+}
+
+
+//----------------------------------------------------------------------
+// RVALUES
+//----------------------------------------------------------------------
+
+void BytecodeCompiler::visit(SimpleRValue& node)
+{
+  // the literal's value was decoded by the type checker
+  set_position(node.value);
+  switch (node.value.type()) {
+    case STRING_VAL: {
+      std::string s;
+      node.literal.value(s);
+      emit(OP_LOADK, dest, string_constant(s));
+      curr_type = "string";
+      return;
+    }
+    case CHAR_VAL: curr_type = "char"; break;
+    case INT_VAL: curr_type = "int"; break;
+    case DOUBLE_VAL: curr_type = "double"; break;
+    case BOOL_VAL: curr_type = "bool"; break;
+    default:
+      emit(OP_LOADNIL, dest);
+      curr_type = "nil";
+      return;
+  }
+  emit(OP_LOADK, dest, constant(node.literal));
+}
+
+
+void BytecodeCompiler::visit(NewRValue& node)
+{
+  std::string type = node.type_id.lexeme();
+  auto it = type_index.find(type);
+  if (it == type_index.end())
+    error("type '" + type + "' not defined", node.type_id);
+  for (const std::string& t : init_types)
+    if (t == type)
+      error("recursive field initializer for type '" + type + "'",
+            node.type_id);
+  int obj = dest;
+  set_position(node.type_id);
+  emit(OP_NEW, obj, it->second);
+  // field initializers run on every allocation, outside of any local
+  // scope, in declaration order
+  init_types.push_back(type);
+  std::vector<Scope> saved_scopes;
+  saved_scopes.swap(scopes);
+  scopes.push_back(Scope());
+  int field = 0;
+  for (VarDeclStmt* v : type_decls[type]->vdecls) {
+    int mark = next_reg;
+    int val = operand(*v->expr);
+    emit(OP_SETF, obj, field++, val);
+    next_reg = mark;
+  }
+  scopes.swap(saved_scopes);
+  init_types.pop_back();
+  curr_type = type;
+}
+
+
+void BytecodeCompiler::visit(CallExpr& node)
+{
+  int reg = dest;
+  int mark = next_reg;
+  std::vector<int> args;
+  // built-in functions (as linked by the resolver) get their own
+  // instructions
+  if (node.built_in != USER_FUN) {
+    for (Expr* e : node.arg_list)
+      args.push_back(operand(*e));
+    set_position(node.function_id);
+    switch (node.built_in) {
+      case PRINT_FUN:
+        emit(OP_PRINT, reg, args[0]);
+        curr_type = "nil";
+        break;
+      case ITOS_FUN:
+        emit(OP_ITOS, reg, args[0]);
+        curr_type = "string";
+        break;
+      case DTOS_FUN:
+        emit(OP_DTOS, reg, args[0]);
+        curr_type = "string";
+        break;
+      case STOI_FUN:
+        emit(OP_STOI, reg, args[0]);
+        curr_type = "int";
+        break;
+      case STOD_FUN:
+        emit(OP_STOD, reg, args[0]);
+        curr_type = "double";
+        break;
+      case LENGTH_FUN:
+        emit(OP_LENGTH, reg, args[0]);
+        curr_type = "int";
+        break;
+      case GET_FUN:
+        emit(OP_GET, reg, args[0], args[1]);
+        curr_type = "char";
+        break;
+      default:
+        emit(OP_READ, reg);
+        curr_type = "string";
+        break;
+    }
+    next_reg = mark;
+    return;
+  }
+  // evaluate the arguments straight into the callee's parameters
+  int base = next_reg;
+  for (size_t i = 0; i < node.arg_list.size(); ++i)
+    alloc_reg();
+  int i = 0;
+  for (Expr* e : node.arg_list) {
+    int arg_mark = next_reg;
+    compile_expr(*e, base + i++);
+    next_reg = arg_mark;
+  }
+  set_position(node.function_id);
+  emit(OP_CALL, fun_index[node.fun], base, reg);
+  curr_type = node.fun->return_type.lexeme();
+  next_reg = mark;
+}
+
+
+void BytecodeCompiler::visit(IDRValue& node)
+{
+  const Token& head = node.path.front();
+  Local* local = lookup(head.lexeme());
+  if (!local)
+    error("undefined variable '" + head.lexeme() + "'", head);
+  set_position(head);
+  std::string type = local->type;
+  if (node.path.size() == 1) {
+    emit(OP_MOVE, dest, local->reg);
+    curr_type = type;
+    return;
+  }
+  int obj = local->reg;
+  auto it = node.path.begin();
+  for (++it; it != node.path.end(); ++it) {
+    int field = field_index(type, *it);
+    type = prog.types[type_index[type]].field_types[field];
+    set_position(*(it - 1));
+    emit(OP_GETF, dest, obj, field);
+    obj = dest;
+  }
+  curr_type = type;
+}
+
+
+void BytecodeCompiler::visit(NegatedRValue& node)
+{
+  // the parser folds 'neg' into Expr::negated, so this is only a
+  // fallback for hand-built trees
+  compile_expr(*node.expr, dest);
+  set_position(node.first_token());
+  negate(node.expr->type, dest);
+}
+
+
+#endif
@@ -35,6 +35,9 @@ public:
   // copying
   DataObject(const DataObject& rhs);
   DataObject& operator=(const DataObject& rhs);
+  // moving
+  DataObject(DataObject&& rhs) noexcept;
+  DataObject& operator=(DataObject&& rhs) noexcept;
   // set/update
   void set(int val);
   void set(double val);
@@ -63,7 +66,21 @@ public:
   // get a string representation
   std::string to_string() const;
  private:
-  void* value_ptr = nullptr;
+  // strings are immutable and shared between copies, the last copy
+  // to go away frees the string
+  struct StringRep {
+    std::string str;
+    size_t refs;
+  };
+  // all other values are stored inline
+  union {
+    int int_val;
+    double double_val;
+    char char_val;
+    bool bool_val;
+    size_t oid_val;
+    StringRep* str_rep;
+  };
   DataType value_type = DataType::NIL;
   void delete_obj();
 };
@@ -75,43 +92,43 @@ public:
 //----------------------------------------------------------------------
 
 DataObject::DataObject()
+  : oid_val(0)
 {
-  set_nil();
 }
 
 DataObject::DataObject(int val)
+  : int_val(val), value_type(DataType::INTEGER)
 {
-  set(val);
 }
 
 DataObject::DataObject(double val)
+  : double_val(val), value_type(DataType::DOUBLE)
 {
-  set(val);
 }
 
 DataObject::DataObject(const char* val)
+  : str_rep(new StringRep{val, 1}), value_type(DataType::STRING)
 {
-  set(std::string(val));
 }
 
 DataObject::DataObject(const std::string& val)
+  : str_rep(new StringRep{val, 1}), value_type(DataType::STRING)
 {
-  set(val);
 }
 
 DataObject::DataObject(char val)
+  : char_val(val), value_type(DataType::CHAR)
 {
-  set(val);
 }
 
 DataObject::DataObject(bool val)
+  : bool_val(val), value_type(DataType::BOOL)
 {
-  set(val);
 }
 
 DataObject::DataObject(size_t val)
+  : oid_val(val), value_type(DataType::OID)
 {
-  set(val);
 }
 
 
@@ -120,18 +137,9 @@ DataObject::DataObject(size_t val)
 //----------------------------------------------------------------------
 void DataObject::delete_obj()
 {
-  if (value_type == DataType::INTEGER)
-    delete (int*)value_ptr;
-  else if (value_type == DataType::DOUBLE)
-    delete (double*)value_ptr;
-  else if (value_type == DataType::STRING)
-    delete (std::string*)value_ptr;
-  else if (value_type == DataType::CHAR)
-    delete (char*)value_ptr;
-  else if (value_type == DataType::BOOL)
-    delete (bool*)value_ptr;
-  else if (value_type == DataType::OID)
-    delete (size_t*)value_ptr;
+  if (value_type == DataType::STRING and --str_rep->refs == 0)
+    delete str_rep;
+  value_type = DataType::NIL;
 }
 
 DataObject::~DataObject()
@@ -145,47 +153,67 @@ DataObject::~DataObject()
 //----------------------------------------------------------------------
 
 DataObject::DataObject(const DataObject& rhs)
+  : value_type(rhs.value_type)
 {
-  *this = rhs;
+  // int, char and bool values fit in the oid member, so copying it
+  // copies whichever of them is set
+  if (value_type == DataType::STRING) {
+    str_rep = rhs.str_rep;
+    ++str_rep->refs;
+  }
+  else if (value_type == DataType::DOUBLE)
+    double_val = rhs.double_val;
+  else
+    oid_val = rhs.oid_val;
 }
 
 DataObject& DataObject::operator=(const DataObject& rhs)
 {
   if (this == &rhs)
     return *this;
-  if (rhs.is_integer()) {
-    int v;
-    rhs.value(v);
-    set(v);
-  }
-  else if (rhs.is_double()) {
-    double v;
-    rhs.value(v);
-    set(v);
-  }
-  else if (rhs.is_string()) {
-    std::string v;
-    rhs.value(v);
-    set(v);
-  }
-  else if (rhs.is_char()) {
-    char v;
-    rhs.value(v);
-    set(v);
-  }
-  else if (rhs.is_bool()) {
-    bool v;
-    rhs.value(v);
-    set(v);
-  }
-  else if (rhs.is_oid()) {
-    size_t v;
-    rhs.value(v);
-    set(v);
-  }
-  else if (rhs.is_nil()) {
-    set_nil();
-  }
+  if (rhs.value_type == DataType::STRING)
+    ++rhs.str_rep->refs;
+  delete_obj();
+  value_type = rhs.value_type;
+  if (value_type == DataType::STRING)
+    str_rep = rhs.str_rep;
+  else if (value_type == DataType::DOUBLE)
+    double_val = rhs.double_val;
+  else
+    oid_val = rhs.oid_val;
+  return *this;
+}
+
+
+//----------------------------------------------------------------------
+// MOVING
+//----------------------------------------------------------------------
+
+DataObject::DataObject(DataObject&& rhs) noexcept
+  : value_type(rhs.value_type)
+{
+  if (value_type == DataType::STRING)
+    str_rep = rhs.str_rep;
+  else if (value_type == DataType::DOUBLE)
+    double_val = rhs.double_val;
+  else
+    oid_val = rhs.oid_val;
+  rhs.value_type = DataType::NIL;
+}
+
+DataObject& DataObject::operator=(DataObject&& rhs) noexcept
+{
+  if (this == &rhs)
+    return *this;
+  delete_obj();
+  value_type = rhs.value_type;
+  if (value_type == DataType::STRING)
+    str_rep = rhs.str_rep;
+  else if (value_type == DataType::DOUBLE)
+    double_val = rhs.double_val;
+  else
+    oid_val = rhs.oid_val;
+  rhs.value_type = DataType::NIL;
   return *this;
 }
 
@@ -197,64 +225,58 @@ DataObject& DataObject::operator=(const DataObject& rhs)
 void DataObject::set(int val)
 {
   delete_obj();
-  value_ptr = new int;
-  *((int*)value_ptr) = val;
+  int_val = val;
   value_type = DataType::INTEGER;
 }
 
 void DataObject::set(double val)
 {
   delete_obj();
-  value_ptr = new double;
-  *((double*)value_ptr) = val;
+  double_val = val;
   value_type = DataType::DOUBLE;
 }
 
 void DataObject::set(const char* val)
 {
-  delete_obj();
-  value_ptr = new std::string;
-  *((std::string*)value_ptr) = val;
-  value_type = DataType::STRING;
+  set(std::string(val));
 }
 
 void DataObject::set(const std::string& val)
 {
+  // reuse the string in place when this is its only reference
+  if (value_type == DataType::STRING and str_rep->refs == 1) {
+    str_rep->str = val;
+    return;
+  }
   delete_obj();
-  value_ptr = new std::string;
-  *((std::string*)value_ptr) = val;
+  str_rep = new StringRep{val, 1};
   value_type = DataType::STRING;
 }
 
 void DataObject::set(char val)
 {
   delete_obj();
-  value_ptr = new char;
-  *((char*)value_ptr) = val;
+  char_val = val;
   value_type = DataType::CHAR;
 }
 
 void DataObject::set(bool val)
 {
   delete_obj();
-  value_ptr = new bool;
-  *((bool*)value_ptr) = val;
+  bool_val = val;
   value_type = DataType::BOOL;
 }
 
 void DataObject::set(size_t val)
 {
   delete_obj();
-  value_ptr = new size_t;
-  *((size_t*)value_ptr) = val;
+  oid_val = val;
   value_type = DataType::OID;
 }
 
 void DataObject::set_nil() 
 {
   delete_obj();
-  value_ptr = nullptr;
-  value_type = DataType::NIL;
 }
 
 
@@ -309,49 +331,49 @@ bool DataObject::is_oid() const
 
 bool DataObject::value(int& val) const
 {
-  if (value_type != DataType::INTEGER or !value_ptr)
+  if (value_type != DataType::INTEGER)
     return false;
-  val = *((int*)value_ptr);
+  val = int_val;
   return true;
 }
 
 bool DataObject::value(double& val) const
 {
-  if (value_type != DataType::DOUBLE or !value_ptr)
+  if (value_type != DataType::DOUBLE)
     return false;
-  val = *((double*)value_ptr);
+  val = double_val;
   return true;
 }
 
 bool DataObject::value(std::string& val) const
 {
-  if (value_type != DataType::STRING or !value_ptr)
+  if (value_type != DataType::STRING)
     return false;
-  val = *((std::string*)value_ptr);
+  val = str_rep->str;
   return true;
 }
 
 bool DataObject::value(char& val) const
 {
-  if (value_type != DataType::CHAR or !value_ptr)
+  if (value_type != DataType::CHAR)
     return false;
-  val = *((char*)value_ptr);
+  val = char_val;
   return true;
 }
 
 bool DataObject::value(bool& val) const
 {
-  if (value_type != DataType::BOOL or !value_ptr)
+  if (value_type != DataType::BOOL)
     return false;
-  val = *((bool*)value_ptr);
+  val = bool_val;
   return true;
 }
 
 bool DataObject::value(size_t& val) const  
 {
-  if (value_type != DataType::OID or !value_ptr)
+  if (value_type != DataType::OID)
     return false;
-  val = *((size_t*)value_ptr);
+  val = oid_val;
   return true;
 }
 
@@ -362,20 +384,20 @@ bool DataObject::value(size_t& val) const
 
 std::string DataObject::to_string() const
 {
-  if (!value_ptr or value_type == DataType::NIL)
+  if (value_type == DataType::NIL)
     return "";
   else if (value_type == DataType::INTEGER)
-    return std::to_string(*((int*)value_ptr));
+    return std::to_string(int_val);
   else if (value_type == DataType::DOUBLE)
-    return std::to_string(*((double*)value_ptr));
+    return std::to_string(double_val);
   else if (value_type == DataType::STRING)
-    return *((std::string*)value_ptr);
+    return str_rep->str;
   else if (value_type == DataType::CHAR)
-    return std::to_string(*((char*)value_ptr));
+    return std::to_string(char_val);
   else if (value_type == DataType::BOOL)
-    return std::to_string(*((bool*)value_ptr));
+    return std::to_string(bool_val);
   else if (value_type == DataType::OID)
-    return std::to_string(*((size_t*)value_ptr));
+    return std::to_string(oid_val);
   //shouldnt ever reach this, just removing warning 
   return "WHAT THE F***";
 }
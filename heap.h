@@ -4,17 +4,22 @@
 // Date: Spring 2021
 // Desc: Basic Heap implementation for the MyPL Interpreter. The Heap
 //       is used to store objects of user-defined types. Each object
-//       has a unique object id (OID) and a collection of key-value
-//       pairs. The keys denote user-defined type variable names and
-//       the values denote the corresponding variable values. Each
-//       value is represented as a DataObject. The key-value pairs are
-//       represented as HeapObjects.
+//       has a unique object id (OID) and a fixed array of field
+//       values. A field's offset is its position in the type's
+//       declaration, which the type checker resolves for every path
+//       expression. Each value is represented as a DataObject. The
+//       field arrays are represented as HeapObjects.
+// Notes: Objects are reclaimed by mark-sweep collection. The heap's
+//        owner marks every root value and then sweeps; objects not
+//        reachable from a root (through oid-valued fields) are
+//        removed.
 //----------------------------------------------------------------------
 
 #ifndef HEAP_H
 #define HEAP_H
 
 #include <unordered_map>
+#include <vector>
 #include "data_object.h"
 
 
@@ -23,35 +28,63 @@ class HeapObject
 public:
 
   //----------------------------------------------------------------------
-  // Add or update a given name with the given data object.
+  // Create an object with the given number of (nil) fields.
   // Inputs:
-  //   att -- the attribute (variable) name
+  //   field_count -- the number of variables of the object's type
+  //----------------------------------------------------------------------
+  HeapObject(size_t field_count = 0);
+
+  //----------------------------------------------------------------------
+  // Create an object whose fields are copies of the given values (e.g.,
+  // a type's prototype).
+  // Inputs:
+  //   fields -- the field values in declaration order
+  //----------------------------------------------------------------------
+  HeapObject(const std::vector<DataObject>& fields);
+
+  //----------------------------------------------------------------------
+  // Update the field at the given offset with the given data object.
+  // Inputs:
+  //   offset -- the field's position in the type declaration
   //   obj -- the attribute (variable) value
   //----------------------------------------------------------------------
-  void set_att(const std::string& att, const DataObject& obj);
+  void set_att(size_t offset, const DataObject& obj);
 
   //----------------------------------------------------------------------
-  // Check if the attribute exists in the heap object
+  // Check if the offset is a field of the heap object
   // Inputs:
-  //   att -- the attribute (variable) to check
+  //   offset -- the field offset to check
   // Returns:
-  //   true if the attribute has been added, false otherwise
+  //   true if the object has a field at the offset, false otherwise
   //----------------------------------------------------------------------
-  bool has_att(const std::string& att) const;
+  bool has_att(size_t offset) const;
 
   //----------------------------------------------------------------------
-  // Get the value of the given attribute
+  // Get the value of the field at the given offset
   // Inputs:
-  //   att -- the attribute to get the value of
+  //   offset -- the offset of the field to get the value of
   // Outputs:
   //   obj -- the value of the object
   // Returns:
-  //   true if the heap object has the given attribute defined
+  //   true if the heap object has a field at the offset
+  //----------------------------------------------------------------------
+  bool get_val(size_t offset, DataObject& val) const;
+
+  //----------------------------------------------------------------------
+  // Access the field at the given offset in place. The offset must be
+  // valid for the object's type (the type checker guarantees this).
+  // Inputs:
+  //   offset -- the offset of the field
+  // Returns:
+  //   a reference to the field's value
   //----------------------------------------------------------------------
-  bool get_val(const std::string& att, DataObject& val);  
+  DataObject& field(size_t offset);
+  const DataObject& field(size_t offset) const;
 
 private:
-  std::unordered_map<std::string,DataObject> attribute_values;
+  friend class Heap;
+  std::vector<DataObject> attribute_values;
+  bool marked = false;
 };
 
 
@@ -66,6 +99,7 @@ public:
   //   obj -- the value of the oid
   //----------------------------------------------------------------------
   void set_obj(size_t oid, const HeapObject& obj);
+  void set_obj(size_t oid, HeapObject&& obj);
 
   //----------------------------------------------------------------------
   // Check if the oid is in the heap.
@@ -87,8 +121,48 @@ public:
   //----------------------------------------------------------------------
   bool get_obj(size_t oid, HeapObject& obj) const;
 
+  //----------------------------------------------------------------------
+  // Get the object associated with the given oid without copying it.
+  // The pointer stays valid until the object is removed from the
+  // heap, even as other objects are added.
+  // Inputs:
+  //   oid -- the oid to look up
+  // Returns:
+  //   the heap object, or nullptr if the oid is not in the heap
+  //----------------------------------------------------------------------
+  HeapObject* get_ref(size_t oid);
+
+  //----------------------------------------------------------------------
+  // Get the number of objects in the heap.
+  //----------------------------------------------------------------------
+  size_t size() const;
+
+  //----------------------------------------------------------------------
+  // Mark the object referenced by the given value (if any) and every
+  // object reachable from it as live.
+  // Inputs:
+  //   val -- a root value
+  //----------------------------------------------------------------------
+  void mark(const DataObject& val);
+
+  //----------------------------------------------------------------------
+  // Remove every object that was not marked since the last sweep, and
+  // clear the marks of the remaining objects.
+  // Outputs:
+  //   bytes -- the approximate number of bytes reclaimed
+  // Returns:
+  //   the number of objects removed
+  //----------------------------------------------------------------------
+  size_t sweep(size_t& bytes);
+
 private:
   std::unordered_map<size_t, HeapObject> heap_objs;
+
+  // objects marked but not yet traced
+  std::vector<HeapObject*> mark_stack;
+
+  // approximate memory used by an object (including its map node)
+  static size_t object_bytes(const HeapObject& obj);
 };
 
 
@@ -96,24 +170,44 @@ private:
 // HeapObject Member Functions
 //----------------------------------------------------------------------
 
-void HeapObject::set_att(const std::string& att, const DataObject& obj)
+HeapObject::HeapObject(size_t field_count)
+  : attribute_values(field_count)
 {
-  attribute_values[att] = obj;
 }
 
-bool HeapObject::has_att(const std::string& att) const
+HeapObject::HeapObject(const std::vector<DataObject>& fields)
+  : attribute_values(fields)
 {
-  return attribute_values.count(att) > 0;
 }
 
-bool HeapObject::get_val(const std::string& att, DataObject& val)
+void HeapObject::set_att(size_t offset, const DataObject& obj)
 {
-  if (!has_att(att))
+  attribute_values[offset] = obj;
+}
+
+bool HeapObject::has_att(size_t offset) const
+{
+  return offset < attribute_values.size();
+}
+
+bool HeapObject::get_val(size_t offset, DataObject& val) const
+{
+  if (!has_att(offset))
     return false;
-  val = attribute_values.at(att);
+  val = attribute_values[offset];
   return true;
 }
 
+DataObject& HeapObject::field(size_t offset)
+{
+  return attribute_values[offset];
+}
+
+const DataObject& HeapObject::field(size_t offset) const
+{
+  return attribute_values[offset];
+}
+
 
 //----------------------------------------------------------------------
 // Heap Member Functions
@@ -125,6 +219,12 @@ void Heap::set_obj(size_t oid, const HeapObject& obj)
 }
 
 
+void Heap::set_obj(size_t oid, HeapObject&& obj)
+{
+  heap_objs[oid] = std::move(obj);
+}
+
+
 bool Heap::has_obj(size_t oid) const
 {
   return heap_objs.count(oid) > 0;
@@ -140,4 +240,72 @@ bool Heap::get_obj(size_t oid, HeapObject& obj) const
 }
 
 
+HeapObject* Heap::get_ref(size_t oid)
+{
+  auto it = heap_objs.find(oid);
+  if (it == heap_objs.end())
+    return nullptr;
+  return &it->second;
+}
+
+
+size_t Heap::size() const
+{
+  return heap_objs.size();
+}
+
+
+void Heap::mark(const DataObject& val)
+{
+  size_t oid;
+  if (!val.value(oid))
+    return;
+  HeapObject* obj = get_ref(oid);
+  if (!obj or obj->marked)
+    return;
+  obj->marked = true;
+  mark_stack.push_back(obj);
+  // trace iteratively so long object chains can't overflow the stack
+  while (!mark_stack.empty()) {
+    HeapObject* next = mark_stack.back();
+    mark_stack.pop_back();
+    for (const DataObject& field : next->attribute_values) {
+      if (!field.value(oid))
+        continue;
+      HeapObject* child = get_ref(oid);
+      if (child and !child->marked) {
+        child->marked = true;
+        mark_stack.push_back(child);
+      }
+    }
+  }
+}
+
+
+size_t Heap::sweep(size_t& bytes)
+{
+  size_t count = 0;
+  bytes = 0;
+  for (auto it = heap_objs.begin(); it != heap_objs.end(); ) {
+    if (it->second.marked) {
+      it->second.marked = false;
+      ++it;
+    }
+    else {
+      bytes += object_bytes(it->second);
+      ++count;
+      it = heap_objs.erase(it);
+    }
+  }
+  return count;
+}
+
+
+size_t Heap::object_bytes(const HeapObject& obj)
+{
+  return sizeof(std::pair<const size_t, HeapObject>) + sizeof(void*) +
+    obj.attribute_values.capacity() * sizeof(DataObject);
+}
+
+
 #endif
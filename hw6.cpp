@@ -9,13 +9,22 @@
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include "token.h"
 #include "mypl_exception.h"
+#include "source_file.h"
 #include "lexer.h"
 #include "parser.h"
 #include "ast.h"
 #include "type_checker.h"
+#include "inliner.h"
+#include "optimizer.h"
+#include "licm.h"
+#include "resolver.h"
+#include "purity.h"
 #include "interpreter.h"
+#include "bytecode.h"
+#include "vm.h"
 
 using namespace std;
 
@@ -23,28 +32,147 @@ using namespace std;
 int main(int argc, char* argv[])
 {
   // use standard input if no input file given
-  istream* input_stream = &cin;
-  if (argc == 2)
-    input_stream = new ifstream(argv[1]);
+  string file_name;
+  // --engine=tree (default) walks the AST, --engine=vm runs bytecode
+  bool use_vm = false;
+  // tree engine garbage collector settings
+  size_t gc_threshold = 0;
+  bool gc_stats = false;
+  bool gc_option = false;       // any of the collector options given
+  // -O0 turns off the AST optimizer, -O1 only folds constants, and
+  // -O2 (default) also removes dead code, inlines functions of at most
+  // inline_size nodes, and hoists loop-invariant expressions
+  int opt_level = 2;
+  size_t inline_size = 24;
+  // tree engine memoization: --memoize caches the results of every pure
+  // function, --memoize=f,g only those of f and g
+  bool memoize = false;
+  vector<string> memo_names;
+  size_t memo_limit = 100000;
+  bool memo_stats = false;
+  bool memo_option = false;     // any of the memoization options given
+  bool opt_report = false;
+  for (int i = 1; i < argc; ++i) {
+    string arg = argv[i];
+    if (arg == "--engine=vm")
+      use_vm = true;
+    else if (arg == "--engine=tree")
+      use_vm = false;
+    else if (arg.rfind("--gc-threshold=", 0) == 0 and
+             arg.find_first_not_of("0123456789", 15) == string::npos and
+             arg.size() > 15) {
+      gc_threshold = stoul(arg.substr(15));
+      gc_option = true;
+    }
+    else if (arg == "--gc-stats")
+      gc_stats = gc_option = true;
+    else if (arg == "-O0" or arg == "-O1" or arg == "-O2")
+      opt_level = arg[2] - '0';
+    else if (arg.rfind("--inline-size=", 0) == 0 and
+             arg.find_first_not_of("0123456789", 14) == string::npos and
+             arg.size() > 14)
+      inline_size = stoul(arg.substr(14));
+    else if (arg == "--opt-report")
+      opt_report = true;
+    else if (arg == "--memoize")
+      memoize = memo_option = true;
+    else if (arg.rfind("--memoize=", 0) == 0 and arg.size() > 10) {
+      memoize = memo_option = true;
+      stringstream names(arg.substr(10));
+      string name;
+      while (getline(names, name, ','))
+        if (name != "")
+          memo_names.push_back(name);
+      // an empty list would otherwise mean every pure function
+      if (memo_names.empty()) {
+        cout << "no function names given to --memoize=" << endl;
+        exit(1);
+      }
+    }
+    else if (arg.rfind("--memo-limit=", 0) == 0 and
+             arg.find_first_not_of("0123456789", 13) == string::npos and
+             arg.size() > 13) {
+      memo_limit = stoul(arg.substr(13));
+      memo_option = true;
+    }
+    else if (arg == "--memo-stats")
+      memo_stats = memo_option = true;
+    else if (arg.rfind("-", 0) == 0) {
+      cout << "usage: " << argv[0] << " [--engine=tree|vm]"
+           << " [--gc-threshold=N] [--gc-stats] [-O0|-O1|-O2]"
+           << " [--inline-size=N] [--opt-report] [--memoize[=f,...]]"
+           << " [--memo-limit=N] [--memo-stats] [file]" << endl;
+      exit(1);
+    }
+    else
+      file_name = arg;
+  }
+  if (use_vm and memo_option) {
+    cout << "memoization is only supported by --engine=tree" << endl;
+    exit(1);
+  }
+  if (use_vm and gc_option) {
+    cout << "garbage collection is only supported by --engine=tree" << endl;
+    exit(1);
+  }
 
-  // create the lexer
-  Lexer lexer(*input_stream);
+  // create the lexer (scanning the mapped file in place)
+  SourceFile source(file_name);
+  if (file_name != "" and !source.is_open()) {
+    cout << "unable to open file '" << file_name << "'" << endl;
+    exit(1);
+  }
+  Lexer lexer = file_name != "" ? Lexer(source.begin(), source.end())
+                                : Lexer(cin);
   Parser parser(lexer);
   // read each token in the file until EOS or error
   Interpreter interpreter;
+  if (gc_threshold)
+    interpreter.set_gc_threshold(gc_threshold);
+  int ret_code = 0;
   try {
     Program ast_root_node;
     parser.parse(ast_root_node);
     TypeChecker type_checker;
     ast_root_node.accept(type_checker);
-    ast_root_node.accept(interpreter);
+    Inliner inliner(opt_level >= 2 ? inline_size : 0);
+    ast_root_node.accept(inliner);
+    Optimizer optimizer(opt_level);
+    ast_root_node.accept(optimizer);
+    LoopHoister hoister(opt_level >= 2);
+    ast_root_node.accept(hoister);
+    if (opt_report) {
+      inliner.print_report(cerr);
+      optimizer.print_report(cerr);
+      hoister.print_report(cerr);
+    }
+    Resolver resolver;
+    ast_root_node.accept(resolver);
+    if (use_vm) {
+      BytecodeProgram bytecode;
+      BytecodeCompiler compiler(bytecode);
+      ast_root_node.accept(compiler);
+      VM vm(bytecode);
+      vm.run();
+      ret_code = vm.return_code();
+    }
+    else {
+      if (memoize) {
+        PurityChecker purity_checker;
+        ast_root_node.accept(purity_checker);
+        interpreter.set_memoize(memo_names, memo_limit);
+      }
+      ast_root_node.accept(interpreter);
+      ret_code = interpreter.return_code();
+      if (gc_stats)
+        interpreter.print_gc_stats(cerr);
+      if (memo_stats)
+        interpreter.print_memo_stats(cerr);
+    }
   } catch (MyPLException e) {
     cout << e.to_string() << endl;
     exit(1);
   }
-  // clean up the input stream
-  if (input_stream != &cin)
-    delete input_stream;
-  return interpreter.return_code();
+  return ret_code;
 }
 
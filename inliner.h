@@ -0,0 +1,652 @@
+//----------------------------------------------------------------------
+// NAME: Brennan Longstreth
+// FILE: inliner.h
+// CONTRIBUTORS:
+// DATE: Fall 2026
+// DESC: Replaces calls to small functions with a copy of the function's
+//       body. A call is inlined where it is the first thing a statement
+//       runs: a call statement, or the leading call of a variable
+//       declaration, assignment, return, or if condition. The arguments
+//       become variable declarations and the body is copied in front of
+//       the statement, which then uses the function's return expression
+//       in place of the call. A function is inlined if it is at most
+//       max_size nodes, can't reach itself in the call graph, and only
+//       returns as its last statement.
+// NOTES: Runs after type checking and before the optimizer. Functions
+//        are inlined into in the order they are declared, so a function
+//        is copied with the calls it makes already inlined. Copied
+//        variables are renamed "_N_name" for the N-th inlined call
+//        (MyPL names can't start with '_'), so they can't clash with or
+//        shadow the caller's variables.
+//----------------------------------------------------------------------
+
+#ifndef INLINER_H
+#define INLINER_H
+
+#include <algorithm>
+#include <iostream>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ast.h"
+
+
+class Inliner : public Visitor
+{
+public:
+
+  // inline functions of at most max_size nodes (0 inlines nothing)
+  Inliner(size_t max_size);
+
+  // top-level
+  void visit(Program& node);
+  void visit(FunDecl& node);
+  void visit(TypeDecl& node);
+  // statements
+  void visit(VarDeclStmt& node);
+  void visit(AssignStmt& node);
+  void visit(ReturnStmt& node);
+  void visit(IfStmt& node);
+  void visit(WhileStmt& node);
+  void visit(ForStmt& node);
+  // expressions
+  void visit(Expr& node);
+  void visit(SimpleTerm& node);
+  void visit(ComplexTerm& node);
+  // rvalues
+  void visit(SimpleRValue& node);
+  void visit(NewRValue& node);
+  void visit(CallExpr& node);
+  void visit(IDRValue& node);
+  void visit(NegatedRValue& node);
+
+  // print the calls that were inlined
+  void print_report(std::ostream& out) const;
+
+private:
+
+  // what the inliner needs to know about a function
+  struct FunInfo
+  {
+    size_t size = 0;              // statements, expressions, and terms
+    std::set<std::string> calls;  // functions it calls
+    bool single_exit = false;     // no return except as last statement
+    bool recursive = false;       // can reach itself through calls
+  };
+
+  size_t max_size;
+
+  // the program's node storage (for the copies)
+  Arena* arena = nullptr;
+
+  // the program's functions by name, and what is known about them
+  std::unordered_map<std::string,FunDecl*> functions;
+  std::unordered_map<std::string,FunInfo> info;
+
+  // set while a function is measured (nothing is inlined), with the
+  // function's info and the returns seen so far
+  bool measuring = false;
+  FunInfo* curr_info = nullptr;
+  size_t returns = 0;
+
+  // the inlined calls (numbered from 1), as report lines
+  std::vector<std::string> inlined;
+
+  // helpers
+  void measure(FunDecl& fun);
+  void find_recursion();
+  void inline_block(std::vector<Stmt*>& stmts);
+  bool inline_stmt(Stmt* stmt, std::vector<Stmt*>& result);
+  FunDecl* inlinable(CallExpr* call, bool as_value);
+  Expr* expand(CallExpr* call, FunDecl* fun, std::vector<Stmt*>& result,
+               size_t& num);
+  VarDeclStmt* temp_decl(size_t num, Token* type, Expr* expr);
+  static SimpleTerm* leading_call(Expr* expr, bool& whole);
+  // copies with the variables renamed
+  Token renamed(const Token& id, const std::string& prefix);
+  std::vector<Stmt*> copy(const std::vector<Stmt*>& stmts,
+                          const std::string& prefix);
+  Stmt* copy(Stmt* stmt, const std::string& prefix);
+  Expr* copy(Expr* expr, const std::string& prefix);
+  ExprTerm* copy(ExprTerm* term, const std::string& prefix);
+  RValue* copy(RValue* rvalue, const std::string& prefix);
+  CallExpr* copy(CallExpr* call, const std::string& prefix);
+};
+
+
+Inliner::Inliner(size_t max_size)
+  : max_size(max_size)
+{
+}
+
+
+void Inliner::print_report(std::ostream& out) const
+{
+  out << "inliner (max size " << max_size << "): " << inlined.size()
+      << " calls inlined" << std::endl;
+  for (const std::string& call : inlined)
+    out << "  " << call << std::endl;
+}
+
+
+// size, calls, and returns of the function's current body
+void Inliner::measure(FunDecl& fun)
+{
+  FunInfo& fi = info[fun.id.lexeme()];
+  fi.size = 0;
+  fi.calls.clear();
+  measuring = true;
+  curr_info = &fi;
+  returns = 0;
+  inline_block(fun.stmts);
+  measuring = false;
+  curr_info = nullptr;
+  bool ends_in_return = !fun.stmts.empty() and
+    dynamic_cast<ReturnStmt*>(fun.stmts.back());
+  fi.single_exit = returns == 0 or (returns == 1 and ends_in_return);
+}
+
+
+// mark the functions that can reach themselves through calls: those
+// calling themselves and those in a strongly connected component of the
+// call graph with others (Tarjan's algorithm, without recursion since
+// call chains can be long)
+void Inliner::find_recursion()
+{
+  std::unordered_map<FunInfo*,size_t> index, low;
+  std::vector<FunInfo*> stack;
+  std::set<FunInfo*> on_stack;
+  // the functions being searched, each with its next callee to search
+  std::vector<std::pair<FunInfo*,std::set<std::string>::iterator>> path;
+  for (auto& root : info) {
+    if (index.count(&root.second))
+      continue;
+    path.push_back({&root.second, root.second.calls.begin()});
+    while (!path.empty()) {
+      FunInfo* f = path.back().first;
+      if (!index.count(f)) {
+        size_t n = index.size();
+        index[f] = low[f] = n;
+        stack.push_back(f);
+        on_stack.insert(f);
+      }
+      std::set<std::string>::iterator& next = path.back().second;
+      if (next != f->calls.end()) {
+        auto it = info.find(*next++);
+        if (it == info.end())
+          continue;
+        FunInfo* g = &it->second;
+        if (g == f)
+          f->recursive = true;
+        if (!index.count(g))
+          path.push_back({g, g->calls.begin()});
+        else if (on_stack.count(g))
+          low[f] = std::min(low[f], index[g]);
+        continue;
+      }
+      path.pop_back();
+      if (!path.empty())
+        low[path.back().first] = std::min(low[path.back().first], low[f]);
+      if (low[f] != index[f])
+        continue;
+      // f is the root of a component
+      std::vector<FunInfo*> component;
+      do {
+        component.push_back(stack.back());
+        on_stack.erase(stack.back());
+        stack.pop_back();
+      } while (component.back() != f);
+      if (component.size() > 1)
+        for (FunInfo* g : component)
+          g->recursive = true;
+    }
+  }
+}
+
+
+void Inliner::inline_block(std::vector<Stmt*>& stmts)
+{
+  std::vector<Stmt*> result;
+  result.reserve(stmts.size());
+  for (Stmt* s : stmts) {
+    s->accept(*this);
+    if (measuring) {
+      ++curr_info->size;
+      result.push_back(s);
+    }
+    else if (inline_stmt(s, result))
+      result.push_back(s);
+  }
+  stmts.swap(result);
+}
+
+
+// the leading call of a statement, or nullptr (whole is set if the
+// call is the entire expression)
+SimpleTerm* Inliner::leading_call(Expr* expr, bool& whole)
+{
+  whole = true;
+  while (true) {
+    if (expr->op or expr->negated)
+      whole = false;
+    if (ComplexTerm* ct = dynamic_cast<ComplexTerm*>(expr->first))
+      expr = ct->expr;
+    else {
+      SimpleTerm* t = dynamic_cast<SimpleTerm*>(expr->first);
+      if (t and dynamic_cast<CallExpr*>(t->rvalue))
+        return t;
+      return nullptr;
+    }
+  }
+}
+
+
+// add the inlined code for the statement's leading call (if any) to
+// the result, returning false if the statement itself is replaced
+bool Inliner::inline_stmt(Stmt* stmt, std::vector<Stmt*>& result)
+{
+  // a call statement is replaced by the body
+  if (CallExpr* call = dynamic_cast<CallExpr*>(stmt)) {
+    FunDecl* fun = inlinable(call, false);
+    if (!fun)
+      return true;
+    size_t num;
+    Expr* ret = expand(call, fun, result, num);
+    // the returned value isn't used, but its expression still runs
+    // (unless it is a literal)
+    bool whole;
+    SimpleTerm* t = ret ? leading_call(ret, whole) : nullptr;
+    SimpleTerm* lit = ret ? dynamic_cast<SimpleTerm*>(ret->first) : nullptr;
+    if (t and whole)
+      result.push_back(static_cast<CallExpr*>(t->rvalue));
+    else if (ret and (ret->op or !lit or
+                      !dynamic_cast<SimpleRValue*>(lit->rvalue)))
+      result.push_back(temp_decl(num, &fun->return_type, ret));
+    return false;
+  }
+  // otherwise the statement's expression must start with the call
+  Expr** expr = nullptr;
+  VarDeclStmt* decl = dynamic_cast<VarDeclStmt*>(stmt);
+  if (decl)
+    expr = &decl->expr;
+  else if (AssignStmt* s = dynamic_cast<AssignStmt*>(stmt))
+    expr = &s->expr;
+  else if (ReturnStmt* s = dynamic_cast<ReturnStmt*>(stmt))
+    expr = &s->expr;
+  else if (IfStmt* s = dynamic_cast<IfStmt*>(stmt))
+    expr = &s->if_part->expr;
+  if (!expr or !*expr)
+    return true;
+  bool whole;
+  SimpleTerm* t = leading_call(*expr, whole);
+  CallExpr* call = t ? static_cast<CallExpr*>(t->rvalue) : nullptr;
+  FunDecl* fun = call ? inlinable(call, true) : nullptr;
+  if (!fun)
+    return true;
+  size_t num;
+  Expr* ret = expand(call, fun, result, num);
+  if (whole) {
+    *expr = ret;
+    // keep the declared type the call had (the return expression may
+    // be a nil literal)
+    if (decl and !decl->type)
+      decl->type = &fun->return_type;
+  }
+  else {
+    // the rest of the expression uses a variable holding the value
+    VarDeclStmt* d = temp_decl(num, &fun->return_type, ret);
+    result.push_back(d);
+    IDRValue* r = arena->make<IDRValue>();
+    r->path.push_back(d->id);
+    t->rvalue = r;
+  }
+  return true;
+}
+
+
+// the function if the call can be inlined (as_value if its result is
+// used)
+FunDecl* Inliner::inlinable(CallExpr* call, bool as_value)
+{
+  const std::string& name = call->function_id.lexeme();
+  auto it = functions.find(name);
+  if (built_in_named(name) != USER_FUN or it == functions.end() or
+      name == "main")
+    return nullptr;
+  FunDecl* fun = it->second;
+  const FunInfo& fi = info[name];
+  if (fi.recursive or !fi.single_exit or fi.size > max_size)
+    return nullptr;
+  bool has_value = !fun->stmts.empty() and
+    dynamic_cast<ReturnStmt*>(fun->stmts.back()) and
+    fun->return_type.type() != NIL;
+  if (as_value and !has_value)
+    return nullptr;
+  return fun;
+}
+
+
+// add the argument declarations and a copy of the body to the result,
+// returning a copy of the returned expression (nullptr if none) and
+// the call's number
+Expr* Inliner::expand(CallExpr* call, FunDecl* fun,
+                      std::vector<Stmt*>& result, size_t& num)
+{
+  const Token& pos = call->function_id;
+  inlined.push_back("inlined call to '" + pos.lexeme() + "' at line " +
+                    std::to_string(pos.line()) + " column " +
+                    std::to_string(pos.column()));
+  num = inlined.size();
+  std::string prefix = "_" + std::to_string(num) + "_";
+  for (size_t i = 0; i < fun->params.size(); ++i) {
+    FunDecl::FunParam& p = fun->params[i];
+    VarDeclStmt* d = arena->make<VarDeclStmt>();
+    d->id = renamed(p.id, prefix);
+    d->type = &p.type;
+    d->expr = call->arg_list[i];
+    // an argument can start with a call of its own
+    if (inline_stmt(d, result))
+      result.push_back(d);
+  }
+  std::vector<Stmt*> body = fun->stmts;
+  ReturnStmt* ret = nullptr;
+  if (!body.empty() and (ret = dynamic_cast<ReturnStmt*>(body.back())))
+    body.pop_back();
+  std::vector<Stmt*> stmts = copy(body, prefix);
+  result.insert(result.end(), stmts.begin(), stmts.end());
+  return ret ? copy(ret->expr, prefix) : nullptr;
+}
+
+
+// a variable holding the value returned by the num-th inlined call
+// (named "_N", which no copied variable can be)
+VarDeclStmt* Inliner::temp_decl(size_t num, Token* type, Expr* expr)
+{
+  const Token& pos = expr->first_token();
+  VarDeclStmt* d = arena->make<VarDeclStmt>();
+  d->id = Token(ID, "_" + std::to_string(num), pos.line(), pos.column());
+  d->type = type;
+  d->expr = expr;
+  return d;
+}
+
+
+//----------------------------------------------------------------------
+// COPYING
+//----------------------------------------------------------------------
+
+Token Inliner::renamed(const Token& id, const std::string& prefix)
+{
+  return Token(ID, prefix + id.lexeme(), id.line(), id.column());
+}
+
+
+std::vector<Stmt*> Inliner::copy(const std::vector<Stmt*>& stmts,
+                                 const std::string& prefix)
+{
+  std::vector<Stmt*> result;
+  for (Stmt* s : stmts)
+    result.push_back(copy(s, prefix));
+  return result;
+}
+
+
+Stmt* Inliner::copy(Stmt* stmt, const std::string& prefix)
+{
+  if (VarDeclStmt* s = dynamic_cast<VarDeclStmt*>(stmt)) {
+    VarDeclStmt* c = arena->make<VarDeclStmt>(*s);
+    c->id = renamed(s->id, prefix);
+    c->expr = copy(s->expr, prefix);
+    return c;
+  }
+  if (AssignStmt* s = dynamic_cast<AssignStmt*>(stmt)) {
+    AssignStmt* c = arena->make<AssignStmt>(*s);
+    c->lvalue_list.front() = renamed(s->lvalue_list.front(), prefix);
+    c->expr = copy(s->expr, prefix);
+    return c;
+  }
+  if (ReturnStmt* s = dynamic_cast<ReturnStmt*>(stmt)) {
+    ReturnStmt* c = arena->make<ReturnStmt>(*s);
+    c->expr = copy(s->expr, prefix);
+    return c;
+  }
+  if (IfStmt* s = dynamic_cast<IfStmt*>(stmt)) {
+    IfStmt* c = arena->make<IfStmt>();
+    std::vector<BasicIf*> parts = s->else_ifs;
+    parts.insert(parts.begin(), s->if_part);
+    for (BasicIf* p : parts) {
+      BasicIf* b = arena->make<BasicIf>();
+      b->expr = copy(p->expr, prefix);
+      b->stmts = copy(p->stmts, prefix);
+      if (!c->if_part)
+        c->if_part = b;
+      else
+        c->else_ifs.push_back(b);
+    }
+    c->body_stmts = copy(s->body_stmts, prefix);
+    return c;
+  }
+  if (WhileStmt* s = dynamic_cast<WhileStmt*>(stmt)) {
+    WhileStmt* c = arena->make<WhileStmt>();
+    c->expr = copy(s->expr, prefix);
+    c->stmts = copy(s->stmts, prefix);
+    return c;
+  }
+  if (ForStmt* s = dynamic_cast<ForStmt*>(stmt)) {
+    ForStmt* c = arena->make<ForStmt>(*s);
+    c->var_id = renamed(s->var_id, prefix);
+    c->start = copy(s->start, prefix);
+    c->end = copy(s->end, prefix);
+    c->stmts = copy(s->stmts, prefix);
+    return c;
+  }
+  return copy(static_cast<CallExpr*>(stmt), prefix);
+}
+
+
+Expr* Inliner::copy(Expr* expr, const std::string& prefix)
+{
+  Expr* c = arena->make<Expr>(*expr);
+  c->first = copy(expr->first, prefix);
+  if (expr->rest)
+    c->rest = copy(expr->rest, prefix);
+  return c;
+}
+
+
+ExprTerm* Inliner::copy(ExprTerm* term, const std::string& prefix)
+{
+  if (SimpleTerm* t = dynamic_cast<SimpleTerm*>(term)) {
+    SimpleTerm* c = arena->make<SimpleTerm>();
+    c->rvalue = copy(t->rvalue, prefix);
+    return c;
+  }
+  ComplexTerm* c = arena->make<ComplexTerm>();
+  c->expr = copy(static_cast<ComplexTerm*>(term)->expr, prefix);
+  return c;
+}
+
+
+RValue* Inliner::copy(RValue* rvalue, const std::string& prefix)
+{
+  if (SimpleRValue* r = dynamic_cast<SimpleRValue*>(rvalue))
+    return arena->make<SimpleRValue>(*r);
+  if (NewRValue* r = dynamic_cast<NewRValue*>(rvalue))
+    return arena->make<NewRValue>(*r);
+  if (IDRValue* r = dynamic_cast<IDRValue*>(rvalue)) {
+    IDRValue* c = arena->make<IDRValue>(*r);
+    c->path.front() = renamed(r->path.front(), prefix);
+    return c;
+  }
+  if (NegatedRValue* r = dynamic_cast<NegatedRValue*>(rvalue)) {
+    NegatedRValue* c = arena->make<NegatedRValue>();
+    c->expr = copy(r->expr, prefix);
+    return c;
+  }
+  return copy(dynamic_cast<CallExpr*>(rvalue), prefix);
+}
+
+
+CallExpr* Inliner::copy(CallExpr* call, const std::string& prefix)
+{
+  CallExpr* c = arena->make<CallExpr>(*call);
+  for (Expr*& e : c->arg_list)
+    e = copy(e, prefix);
+  return c;
+}
+
+
+//----------------------------------------------------------------------
+// TOP-LEVEL
+//----------------------------------------------------------------------
+
+void Inliner::visit(Program& node)
+{
+  if (max_size == 0)
+    return;
+  arena = &node.arena;
+  // build the call graph
+  for (Decl* d : node.decls)
+    if (FunDecl* f = dynamic_cast<FunDecl*>(d)) {
+      functions[f->id.lexeme()] = f;
+      measure(*f);
+    }
+  find_recursion();
+  // inline into each function, then measure what it grew to
+  for (Decl* d : node.decls)
+    d->accept(*this);
+}
+
+
+void Inliner::visit(FunDecl& node)
+{
+  inline_block(node.stmts);
+  measure(node);
+}
+
+
+void Inliner::visit(TypeDecl&)
+{
+  // field initializers aren't statements, so nothing is inlined there
+}
+
+
+//----------------------------------------------------------------------
+// STATEMENTS
+//----------------------------------------------------------------------
+
+void Inliner::visit(VarDeclStmt& node)
+{
+  node.expr->accept(*this);
+}
+
+
+void Inliner::visit(AssignStmt& node)
+{
+  node.expr->accept(*this);
+}
+
+
+void Inliner::visit(ReturnStmt& node)
+{
+  ++returns;
+  if (node.expr)
+    node.expr->accept(*this);
+}
+
+
+void Inliner::visit(IfStmt& node)
+{
+  node.if_part->expr->accept(*this);
+  inline_block(node.if_part->stmts);
+  for (BasicIf* b : node.else_ifs) {
+    b->expr->accept(*this);
+    inline_block(b->stmts);
+  }
+  inline_block(node.body_stmts);
+}
+
+
+void Inliner::visit(WhileStmt& node)
+{
+  node.expr->accept(*this);
+  inline_block(node.stmts);
+}
+
+
+void Inliner::visit(ForStmt& node)
+{
+  node.start->accept(*this);
+  node.end->accept(*this);
+  inline_block(node.stmts);
+}
+
+
+//----------------------------------------------------------------------
+// EXPRESSIONS (only visited to measure them)
+//----------------------------------------------------------------------
+
+void Inliner::visit(Expr& node)
+{
+  if (measuring)
+    ++curr_info->size;
+  node.first->accept(*this);
+  if (node.rest)
+    node.rest->accept(*this);
+}
+
+
+void Inliner::visit(SimpleTerm& node)
+{
+  node.rvalue->accept(*this);
+}
+
+
+void Inliner::visit(ComplexTerm& node)
+{
+  node.expr->accept(*this);
+}
+
+
+void Inliner::visit(SimpleRValue&)
+{
+  if (measuring)
+    ++curr_info->size;
+}
+
+
+void Inliner::visit(NewRValue&)
+{
+  if (measuring)
+    ++curr_info->size;
+}
+
+
+void Inliner::visit(CallExpr& node)
+{
+  if (measuring) {
+    ++curr_info->size;
+    const std::string& name = node.function_id.lexeme();
+    if (built_in_named(name) == USER_FUN)
+      curr_info->calls.insert(name);
+  }
+  for (Expr* e : node.arg_list)
+    e->accept(*this);
+}
+
+
+void Inliner::visit(IDRValue&)
+{
+  if (measuring)
+    ++curr_info->size;
+}
+
+
+void Inliner::visit(NegatedRValue& node)
+{
+  node.expr->accept(*this);
+}
+
+
+#endif
@@ -4,7 +4,9 @@
 // CONTRIBUTORS: Shawn Bowers
 // DATE: Spring 2021
 // DESC: Interpreter to run MyPL code after type checking is done.
-// NOTES: 
+// NOTES: Heap objects are garbage collected. Roots are the variable
+//        slots, curr_val, and temp_roots, which holds object values
+//        that only live in C++ locals while a sub-expression runs.
 //----------------------------------------------------------------------
 
 
@@ -12,10 +14,12 @@
 #define INTERPRETER_H
 
 #include <iostream>
+#include <algorithm>
+#include <chrono>
 #include <unordered_map>
-#include <regex>
+#include <unordered_set>
+#include <vector>
 #include "ast.h"
-#include "symbol_table.h"
 #include "data_object.h"
 #include "heap.h"
 
@@ -49,14 +53,37 @@ public:
   // return code from calling main
   int return_code() const;
 
-  
+  // collect garbage whenever the heap reaches this many objects (the
+  // limit grows with the live heap so collection stays amortized)
+  void set_gc_threshold(size_t threshold);
+
+  // print the number of collections, pause times, and reclaimed space
+  void print_gc_stats(std::ostream& out) const;
+
+  // cache the results of the named functions (every pure function if
+  // there are no names) by argument values, keeping at most limit
+  // results per function (run the PurityChecker first)
+  void set_memoize(const std::vector<std::string>& names, size_t limit);
+
+  // print the cache hits, misses, and size of each memoized function
+  void print_memo_stats(std::ostream& out) const;
+
 private:
 
-  // return exception
-  class MyPLReturnException : public std::exception {};
+  // set by a return statement; blocks and loops stop executing
+  // statements until the enclosing call clears it
+  bool returning = false;
   
-  // the symbol table 
-  SymbolTable sym_table;
+  // the frames of all active calls, innermost last (the resolver
+  // gives each variable a slot in its function's frame)
+  std::vector<DataObject> slots;
+
+  // index in slots where the current call's frame starts
+  size_t frame_base = 0;
+
+  // set by a tail call (with returning) to the function the enclosing
+  // call runs next in the same frame; its args are on top of slots
+  FunDecl* tail_fun = nullptr;
 
   // holds the previously computed value
   DataObject curr_val;
@@ -66,19 +93,59 @@ private:
 
   // the next oid
   size_t next_oid = 0;
-  
-  // the functions (all within the global environment)
-  std::unordered_map<std::string,FunDecl*> functions;
-  
-  // the user-defined types (all within the global environment)
-  std::unordered_map<std::string,TypeDecl*> types;
 
-  // the global environment id
-  int global_env_id = 0;
+  // values that must survive a collection but aren't in a slot yet
+  // (pending call arguments, left operands, objects being built)
+  std::vector<DataObject> temp_roots;
+
+  // collector settings and statistics
+  size_t gc_threshold = 100000;
+  size_t gc_limit = 100000;
+  size_t gc_count = 0;
+  size_t gc_objects = 0;
+  size_t gc_bytes = 0;
+  double gc_total_ms = 0;
+  double gc_max_ms = 0;
   
+  // a memoized function's results by argument values (see memo_key)
+  struct Memo
+  {
+    std::unordered_map<std::string,DataObject> results;
+    size_t hits = 0;
+    size_t misses = 0;
+  };
+
+  // memoization settings, and the memoized functions in the order
+  // they are declared
+  bool memoize = false;
+  bool memoize_all = false;
+  std::unordered_set<std::string> memoize_names;
+  size_t memo_limit = 0;
+  std::unordered_map<FunDecl*,Memo> memos;
+  std::vector<FunDecl*> memo_order;
+
+  // the main function (calls and news are linked to their
+  // functions and types by the resolver)
+  FunDecl* main_fun = nullptr;
+
   // the program return code
   int ret_code = 0;
 
+  // run a block's statements, stopping early on a return
+  void exec_block(std::vector<Stmt*>& stmts);
+
+  // a variable of the current frame
+  DataObject& variable(int slot);
+
+  // the object referenced by a path step (reports nil references)
+  HeapObject& object(const DataObject& ref, const Token& token);
+
+  // mark-sweep collection of unreachable heap objects
+  void collect();
+
+  // the cache key of the call arguments in slots [base, base+count)
+  void memo_key(size_t base, size_t count, std::string& key) const;
+
   // error message
   void error(const std::string& msg, const Token& token);
   void error(const std::string& msg); 
@@ -91,6 +158,74 @@ int Interpreter::return_code() const
   return ret_code;
 }
 
+
+void Interpreter::set_gc_threshold(size_t threshold)
+{
+  gc_threshold = threshold;
+  gc_limit = threshold;
+}
+
+
+void Interpreter::print_gc_stats(std::ostream& out) const
+{
+  out << "gc: " << gc_count << " collections, "
+      << gc_objects << " objects (" << gc_bytes << " bytes) reclaimed, "
+      << "pause total " << gc_total_ms << " ms, max " << gc_max_ms
+      << " ms, " << heap.size() << " objects live" << std::endl;
+}
+
+void Interpreter::set_memoize(const std::vector<std::string>& names,
+                              size_t limit)
+{
+  memoize = true;
+  memoize_all = names.empty();
+  memoize_names.insert(names.begin(), names.end());
+  memo_limit = limit;
+}
+
+
+void Interpreter::print_memo_stats(std::ostream& out) const
+{
+  for (FunDecl* f : memo_order) {
+    const Memo& m = memos.at(f);
+    out << "memo: " << f->id.lexeme() << ": " << m.hits << " hits, "
+        << m.misses << " misses, " << m.results.size()
+        << " results cached" << std::endl;
+  }
+}
+
+
+// each argument's type followed by its exact value (so doubles that
+// print the same are still told apart)
+void Interpreter::memo_key(size_t base, size_t count, std::string& key) const
+{
+  key.clear();
+  for (size_t i = base; i < base + count; ++i) {
+    const DataObject& arg = slots[i];
+    key += char(arg.type());
+    int int_val;
+    double double_val;
+    char char_val;
+    bool bool_val;
+    std::string str_val;
+    if (arg.value(int_val))
+      key.append(reinterpret_cast<const char*>(&int_val), sizeof(int_val));
+    else if (arg.value(double_val))
+      key.append(reinterpret_cast<const char*>(&double_val),
+                 sizeof(double_val));
+    else if (arg.value(char_val))
+      key += char_val;
+    else if (arg.value(bool_val))
+      key += char(bool_val);
+    else if (arg.value(str_val)) {
+      size_t length = str_val.size();
+      key.append(reinterpret_cast<const char*>(&length), sizeof(length));
+      key += str_val;
+    }
+  }
+}
+
+
 void Interpreter::error(const std::string& msg, const Token& token)
 {
   throw MyPLException(RUNTIME, msg, token.line(), token.column());
@@ -103,118 +238,136 @@ void Interpreter::error(const std::string& msg)
 }
 
 
-// TODO: finish the visitor functions
-void Interpreter::visit(Program& node) { 
-  // push  the  global  environment
-  sym_table.push_environment ();
+void Interpreter::exec_block(std::vector<Stmt*>& stmts)
+{
+  for (Stmt* s : stmts) {
+    s->accept(*this);
+    if (returning)
+      return;
+  }
+}
+
+
+DataObject& Interpreter::variable(int slot)
+{
+  return slots[frame_base + slot];
+}
+
+
+HeapObject& Interpreter::object(const DataObject& ref, const Token& token)
+{
+  size_t oid;
+  HeapObject* obj = nullptr;
+  if (ref.value(oid))
+    obj = heap.get_ref(oid);
+  if (!obj)
+    error("nil object in path expression", token);
+  return *obj;
+}
+
 
-  //  store  the  global  envirionment  id
-  global_env_id = sym_table.get_environment_id ();
+void Interpreter::collect()
+{
+  auto start = std::chrono::steady_clock::now();
+  for (const DataObject& val : slots)
+    heap.mark(val);
+  for (const DataObject& val : temp_roots)
+    heap.mark(val);
+  heap.mark(curr_val);
+  size_t bytes;
+  gc_objects += heap.sweep(bytes);
+  gc_bytes += bytes;
+  gc_limit = std::max(gc_threshold, 2 * heap.size());
+  std::chrono::duration<double,std::milli> pause =
+    std::chrono::steady_clock::now() - start;
+  ++gc_count;
+  gc_total_ms += pause.count();
+  gc_max_ms = std::max(gc_max_ms, pause.count());
+}
 
-  // add  the  functions  and user -defined  types
+
+void Interpreter::visit(Program& node) { 
+  // find the main function
   for(Decl* d : node.decls) {
     d->accept (*this);
   }
+  for(const std::string& name : memoize_names) {
+    error("no function '" + name + "' to memoize");
+  }
 
   //  execute  the  main  function
   CallExpr  expr;
-  expr.function_id = functions["main"]->id;
+  expr.function_id = main_fun->id;
+  expr.fun = main_fun;
   expr.accept (*this);
-
-  // pop  the  global  environment
-  sym_table.pop_environment ();
 }
 
 void Interpreter::visit(FunDecl& node) { 
   //std::cout << "Function Declaration "<< node.params.size() << std::endl;
-  //add function to list of functions
-  functions.insert(std::pair<std::string,FunDecl*>(node.id.lexeme(),&node));
+  if(node.id.lexeme() == "main") {
+    main_fun = &node;
+  }
+  //memoize every pure function, or the ones named (which must be)
+  bool named = memoize_names.erase(node.id.lexeme());
+  if(memoize && (memoize_all ? node.pure : named)) {
+    if(!node.pure) {
+      error("cannot memoize '" + node.id.lexeme() + "' (it isn't pure)", node.id);
+    }
+    memos[&node];
+    memo_order.push_back(&node);
+  }
 }
 void Interpreter::visit(TypeDecl& node) { 
   //std::cout << "Type Declaration" << std::endl;
-  //add type to list of types
-  types.insert(std::pair<std::string,TypeDecl*>(node.id.lexeme(),&node));
+  //build the prototype new objects are copied from: literal field
+  //defaults are stored in it once, anything else is evaluated for
+  //each new object
+  node.prototype.assign(node.vdecls.size(), DataObject());
+  node.computed_fields.clear();
+  for(size_t offset = 0; offset < node.vdecls.size(); ++offset) {
+    Expr* e = node.vdecls[offset]->expr;
+    SimpleTerm* t = dynamic_cast<SimpleTerm*>(e->first);
+    SimpleRValue* r = t ? dynamic_cast<SimpleRValue*>(t->rvalue) : nullptr;
+    if(r && !e->op && !e->negated) {
+      node.prototype[offset] = r->literal;
+    }else {
+      node.computed_fields.push_back(offset);
+    }
+  }
 }
 
 // statements
 void Interpreter::visit(VarDeclStmt& node) { 
   //std::cout << "Variable Declaration Statement" << std::endl;
-  if(sym_table.name_exists(node.id.lexeme())) { //check for shadowing
-    error(node.id.lexeme() + " already exists in this environment",node.id);
-  }
-  sym_table.add_name(node.id.lexeme());
-
   if(node.expr) {
     node.expr->accept(*this);
-    //std::cout << curr_val.is_oid() << std::endl;
-    sym_table.set_val_info(node.id.lexeme(),curr_val);
-    //std::cout << sym_table.to_string();
   }else {
     curr_val.set_nil();
-    sym_table.set_val_info(node.id.lexeme(),curr_val);
   }
+  variable(node.slot) = curr_val;
 }
 void Interpreter::visit(AssignStmt& node) { 
   //std::cout << "Assign Statement " << node.lvalue_list.size() << std::endl;
   node.expr->accept(*this);
-  if(sym_table.has_val_info(node.lvalue_list.front().lexeme())) {
-    //std::cout << "Somethin" << std::endl;
-    if(node.lvalue_list.size() == 1) {
-      sym_table.set_val_info(node.lvalue_list.front().lexeme(),curr_val);
-      //std::cout << "Assign " << node.lvalue_list.front().lexeme() << std::endl;
-    }else {
-      DataObject trav;
-      HeapObject ho;
-      size_t oid;
-      //gets initial OID DataObject
-      auto lvl = (node.lvalue_list.begin());
-      sym_table.get_val_info(lvl->lexeme(),trav); 
-      
-      //std::cout << "Var named: " << lvl->lexeme() << " = " << trav.to_string() << std::endl;
-      //setup for list traversal iterator, starting on second element
-      lvl++;
-      //while loop for traversal of loop (stops on !OID or 1 before end of list)
-      
-      while(lvl != --(node.lvalue_list.end())) {
-        trav.value(oid);
-        heap.get_obj(oid,ho);
-        ho.get_val(lvl->lexeme(),trav);
-        //std::cout << "using OID stored at: " << lvl->lexeme() << " = " << trav.to_string() <<std::endl;
-        lvl++;
-      }
-      //std::cout << "using val stored at: " << lvl->lexeme() << std::endl;
-      //set oid value to second to last node in the call tree value
-      trav.value(oid);
-      //std::cout << " - " << oid << std::endl;
-      if(heap.has_obj(oid)) {
-        heap.get_obj(oid,ho);
-        //ho.get_val((lvl)->lexeme(),trav);
-        //std::cout << lvl->lexeme() << " " << oid << std::endl;
-      }else {
-        error("Object missing from heap",*lvl);
-      }
-      //heap.print();
-      //std::cout << "--------------------------" << std::endl;
-      //std::cout << "cur val: " << curr_val.to_string() << std::endl;
-      //std::cout << "iter val: " << lvl->lexeme() << std::endl;
-      //std::cout << "stored val: " << trav.to_string() << std::endl;
-      //std::cout << "has x : " << ho.has_att("x")? (lvl->lexeme() == "v") <<  << std::endl;
-      ho.set_att(lvl->lexeme(),curr_val); 
-      heap.set_obj(oid,ho); 
-      //heap.print();
-      //std::cout << "--------------------------" << std::endl;
-    }
+  if(node.lvalue_list.size() == 1) {
+    variable(node.slot) = curr_val;
+    //std::cout << "Assign " << node.lvalue_list.front().lexeme() << std::endl;
   }else {
-    std::cout << "something is missing" << std::endl;
+    //walk the path in place down to the object holding the last field
+    auto lvl = node.lvalue_list.begin();
+    const DataObject* trav = &variable(node.slot);
+    for(size_t i = 0; i + 1 < node.offsets.size(); ++i) {
+      trav = &object(*trav,*lvl++).field(node.offsets[i]);
+    }
+    object(*trav,*lvl).field(node.offsets.back()) = curr_val;
   }
-  //std::cout << sym_table.to_string()<< std::endl;
 }
 void Interpreter::visit(ReturnStmt& node) { 
   //std::cout << "Return Statement" << std::endl;
   //  evaluate  the  expression
   node.expr ->accept (*this);
-  //  throw  the  return  exception
-  throw new MyPLReturnException;
+  //  unwind to the call (curr_val holds the return value)
+  returning = true;
 }
 void Interpreter::visit(IfStmt& node) { 
   //std::cout << "If Statement" << std::endl;
@@ -223,25 +376,20 @@ void Interpreter::visit(IfStmt& node) {
   curr_val.value(cond);
   if(cond) {
     flag = true;
-    for(Stmt*  s : node.if_part->stmts) {
-      s->accept(*this);
-    }
+    exec_block(node.if_part->stmts);
   }else {
     for(BasicIf* bi : node.else_ifs) {
       bi->expr->accept(*this);
       curr_val.value(cond);
       if(cond) {
         flag = true;
-        for(Stmt* s : bi->stmts) {
-          s->accept(*this);
-        }
+        exec_block(bi->stmts);
+        break; // only the first matching else if runs
       }
     }
   }
   if(!flag) {
-    for(Stmt* s : node.body_stmts) {
-      s->accept(*this);
-    }
+    exec_block(node.body_stmts);
   }
 }
 void Interpreter::visit(WhileStmt& node) {
@@ -250,192 +398,75 @@ void Interpreter::visit(WhileStmt& node) {
   bool loop_condition;
   curr_val.value(loop_condition);
   while(loop_condition) {
-    sym_table.push_environment();
-    for(Stmt*  s : node.stmts) {
-      s->accept(*this);
+    exec_block(node.stmts);
+    if(returning) {
+      break;
     }
-    sym_table.pop_environment();
 
     //check loop condition again
     node.expr->accept(*this);
     curr_val.value(loop_condition);
-    //std::cout << loop_condition << " - loop cond \n" << sym_table.to_string() << std::endl;
   }
 
 }
 void Interpreter::visit(ForStmt& node) {
   //std::cout << "For Statement" << std::endl;
-  //set up loop variable
-  sym_table.push_environment();
-  sym_table.add_name(node.var_id.lexeme());
+  //the bounds are evaluated once
+  int start_val,end_val;
   node.start->accept(*this);
-  int index,end_val;
-  DataObject id;
-  curr_val.value(index);
-  sym_table.set_val_info(node.var_id.lexeme(),curr_val);
+  if(!curr_val.value(start_val)) {
+    error("nil for loop start", node.start->first_token());
+  }
   node.end->accept(*this);
-  curr_val.value(end_val);
-  while(index <= end_val) {
-    //loop statements
-    sym_table.push_environment();
-    for(Stmt* s : node.stmts) {
-      s->accept(*this);
+  if(!curr_val.value(end_val)) {
+    error("nil for loop end", node.end->first_token());
+  }
+  //the counter is kept here and the (read-only) loop variable is set
+  //from it each iteration
+  for(int index = start_val; index <= end_val; ++index) {
+    variable(node.slot).set(index);
+    exec_block(node.stmts);
+    if(returning || index == end_val) {
+      break;
     }
-    sym_table.pop_environment();
-    //increment loop var
-    sym_table.get_val_info(node.var_id.lexeme(),id);
-    id.value(index);
-    id.set(++index);
-    sym_table.set_val_info(node.var_id.lexeme(),id);
   }
-  sym_table.pop_environment();
 }
 // expressions
 void Interpreter::visit(Expr& node) {
   //std::cout << "Expression" << std::endl;
   node.first->accept(*this);
-  if(node.op) {
-    DataObject  lhs_val = curr_val;
-    node.rest ->accept (*this);
-    DataObject  rhs_val = curr_val;
-    TokenType  op = node.op->type ();
-    //  start  checking  various  cases (there  are  many!)
-    // be sure to set  computed  value in  curr_val
-    std::string operation = node.op->lexeme();
-    if(lhs_val.is_nil()) {
-      bool l,r;
-      l = lhs_val.is_nil();
-      r = rhs_val.is_nil();
-      if(operation == "==") curr_val.set(r == l);
-      else if (operation == "!=") curr_val.set(l != r);
-      else { 
-          error("Expression term is nil", node.rest->first_token());
-      }
-    }else if(rhs_val.is_nil()) {
-      bool l,r;
-      l = lhs_val.is_nil();
-      r = rhs_val.is_nil();
-      if(operation == "==") curr_val.set(r == l);
-      else if (operation == "!=") curr_val.set(l != r);
-      else { 
-          error("Expression term is nil", node.rest->first_token());
-      }
-      
-    }else if(lhs_val.is_oid()) {
-      //get OIDs
-      int lOID,rOID;
-      if(heap.has_obj(lOID) && heap.has_obj(rOID)) {
-        HeapObject l,r;
-        heap.get_obj(lOID,l);
-        heap.get_obj(rOID,r);
-        //get the names of both
-        //------------------------------------------------------------
-        
-        //check equal for each one
-        if(operation == "==") {
-          
-        }else if (operation == "!=") {
-
-        }
-      }else {
-        error("Object in expression not on heap",node.first_token());
-      }
-
-
-    }else
-    if(lhs_val.is_double()) {
-      if(rhs_val.is_double()) {
-        double l,r;
-        lhs_val.value(l);
-        rhs_val.value(r);
-        if(operation == "+") curr_val.set(l+r);
-        else if(operation == "-") curr_val.set(l-r);
-        else if(operation == "*") curr_val.set(l*r);
-        else if(operation == "/") curr_val.set(l/r);
-        else if(operation == "==") curr_val.set(l==r);
-        else if(operation == "!=") curr_val.set(l!=r);
-        else if(operation == "<") curr_val.set(l<r);
-        else if(operation == "<=") curr_val.set(l<=r);
-        else if(operation == ">") curr_val.set(l>r);
-        else if(operation == ">=") curr_val.set(l>=r);
-      }
-    }else 
-    if(lhs_val.is_integer()) {
-      if(rhs_val.is_integer()) {
-        int l,r;
-        lhs_val.value(l);
-        rhs_val.value(r);
-        
-        if(operation == "+") curr_val.set(l+r);
-        else if(operation == "-") curr_val.set(l-r);
-        else if(operation == "*") curr_val.set(l*r);
-        else if(operation == "/") curr_val.set(l/r);
-        else if(operation == "==") curr_val.set(l==r);
-        else if(operation == "!=") curr_val.set(l!=r);
-        else if(operation == "<") curr_val.set(l<r);
-        else if(operation == "<=") curr_val.set(l<=r);
-        else if(operation == ">") curr_val.set(l>r);
-        else if(operation == ">=") curr_val.set(l>=r);
-        else if(operation == "%") curr_val.set(l%r);
-      }
-    }else
-    if(lhs_val.is_string()) {
-
-      if(rhs_val.is_string()) {
-        std::string l,r;
-        lhs_val.value(l);
-        rhs_val.value(r);
-        
-        if(operation == "+") curr_val.set(l+r);
-        else if(operation == "==") curr_val.set(l==r);
-        else if(operation == "!=") curr_val.set(l!=r);
-        else if(operation == "<") curr_val.set(l<r);
-        else if(operation == "<=") curr_val.set(l<=r);
-        else if(operation == ">") curr_val.set(l>r);
-        else if(operation == ">=") curr_val.set(l>=r);
-      }else {
-        std::string l;
-        char r;
-        lhs_val.value(l);
-        rhs_val.value(r);
-        if(operation == "+") curr_val.set(l+r);
-      }
-    }else 
-    if(lhs_val.is_char()) {
-      if(rhs_val.is_char()) {
-        char l,r;
-        lhs_val.value(l);
-        rhs_val.value(r);
-
-        if(operation == "+") curr_val.set(l+r);
-        else if(operation == "==") curr_val.set(l==r);
-        else if(operation == "!=") curr_val.set(l!=r);
-        else if(operation == "<") curr_val.set(l<r);
-        else if(operation == "<=") curr_val.set(l<=r);
-        else if(operation == ">") curr_val.set(l>r);
-        else if(operation == ">=") curr_val.set(l>=r);
-      }else {
-        char l;
-        std::string r;
-        lhs_val.value(l);
-        rhs_val.value(r);
-        if(operation == "+") curr_val.set(l+r);
+  if(node.bin_op == BIN_AND || node.bin_op == BIN_OR) {
+    //the rest only runs if the first term doesn't decide the result
+    bool val;
+    if(!curr_val.value(val)) {
+      error("Expression term is nil", node.rest->first_token());
+    }
+    if(val != (node.bin_op == BIN_OR)) {
+      node.rest->accept(*this);
+      if(!curr_val.is_bool()) {
+        error("Expression term is nil", node.rest->first_token());
       }
-    }else
-    if(lhs_val.is_bool() || rhs_val.is_bool()) {
-      //std::cout << "Found bool" << std::endl;
-      bool l,r;
-      lhs_val.value(l);
-      rhs_val.value(r);
-
-      if(operation == "==") curr_val.set(l==r);
-      else if(operation == "!=") curr_val.set(l!=r);
-      else if(operation == "and") curr_val.set(l&&r);
-      else if(operation == "or") curr_val.set(l||r);
-      //std::cout << "\nCurrent Values: " << lhs_val.to_string() << " " << rhs_val.to_string() << std::endl;
     }
-    else {
-      std::cout << "something went wrong" << std::endl;
+  }else if(node.op) {
+    DataObject  lhs_val = std::move(curr_val);
+    //an object operand must stay reachable while the rest runs
+    bool rooted = lhs_val.is_oid();
+    if(rooted) {
+      temp_roots.push_back(lhs_val);
+    }
+    node.rest ->accept (*this);
+    if(rooted) {
+      temp_roots.pop_back();
+    }
+    DataObject  rhs_val = std::move(curr_val);
+    //  run the kernel the type checker picked for the operator and
+    //  operand types (it sets curr_val)
+    if(!node.kernel) {
+      error("Illegal operator '" + node.op->lexeme() + "'", *node.op);
+    }
+    const char* err = node.kernel(lhs_val,rhs_val,curr_val);
+    if(err) {
+      error(err, node.rest->first_token());
     }
   }
   if(node.negated) {
@@ -466,76 +497,57 @@ void Interpreter::visit(ComplexTerm& node) {
 // rvalues
 void Interpreter::visit(SimpleRValue& node) { 
   //std::cout << "Simple R Value" << std::endl;
-  if(node.value.type() ==  CHAR_VAL)
-    curr_val.set(node.value.lexeme ().at(0));
-  else if(node.value.type() ==  STRING_VAL) 
-    curr_val.set(node.value.lexeme ());
-  else if(node.value.type() ==  INT_VAL) {
-    try{curr_val.set(std::stoi(node.value.lexeme ()));
-    }catch(const std::invalid_argument& e) {
-      error("internal  error", node.value );
-    }catch(const std::out_of_range& e) {
-      error("int out of range", node.value );
-    }
-  }else if(node.value.type() ==  DOUBLE_VAL) {
-    try{curr_val.set(std::stod(node.value.lexeme ()));
-    }catch(const std::invalid_argument& e) {
-      error("internal  error", node.value );
-    }catch(const std::out_of_range& e) {
-      error("double  out of range", node.value );
-    }
-  }else if(node.value.type() ==  BOOL_VAL) {
-    if(node.value.lexeme () == "true")curr_val.set(true);
-    else curr_val.set(false);
-  }else if(node.value.type() == NIL)
-    curr_val.set_nil ();
+  //decoded by the type checker
+  curr_val = node.literal;
 }
 
 void Interpreter::visit(NewRValue& node) { 
   //std::cout << "New R Value" << std::endl;
   
-  HeapObject ho;
-  TypeDecl* td;
-  if(!(types.find(node.type_id.lexeme()) == types.end())) {
-    td = types[node.type_id.lexeme()];
-  }
-  else {
-    error("type '" + node.type_id.lexeme() + "' not defined", node.type_id);
-  }
-  //set default values for heap object
-  //std::cout << "storing '" << node.type_id.lexeme() << "' at: " << next_oid << std::endl;
-  for(VarDeclStmt* v : td->vdecls) {
-    DataObject d;
-    v->expr->accept(*this);
-    d = curr_val;
-    ho.set_att(v->id.lexeme(),d);
-    //std::cout << "  Var: " <<  v->id.lexeme() << " val: " << d.to_string() << std::endl;
+  TypeDecl* td = node.type;
+  if(heap.size() >= gc_limit) {
+    collect();
   }
+  //copy the type's prototype, then add the object (rooted) before
+  //running the remaining initializers so ones that allocate can't
+  //collect the fields set so far
   next_oid++;
-  curr_val.set(next_oid);
-  heap.set_obj(next_oid,ho);
+  DataObject ref;
+  ref.set(next_oid);
+  heap.set_obj(next_oid,HeapObject(td->prototype));
+  if(!td->computed_fields.empty()) {
+    HeapObject* ho = heap.get_ref(next_oid);
+    temp_roots.push_back(ref);
+    for(size_t offset : td->computed_fields) {
+      td->vdecls[offset]->expr->accept(*this);
+      ho->set_att(offset,curr_val);
+    }
+    temp_roots.pop_back();
+  }
+  curr_val = ref;
 }
 
 void Interpreter::visit(CallExpr& node) {   
   //std::cout << "Call Expression: " << node.function_id.lexeme() << std::endl;
-  std:: string  fun_name = node.function_id.lexeme ();
-  //  check  for built -in  functions
-  if(fun_name  == "print") {
+  //  the resolver linked the call to a built-in or a function
+  switch(node.built_in) {
+  case PRINT_FUN:
     node.arg_list.front()->accept (*this);
-    std:: string s = curr_val.to_string ();
-    s = std::regex_replace(s, std::regex("\\\\n"), "\n");
-    s = std::regex_replace(s, std::regex("\\\\t"), "\t");
-    std::cout << s; //<< std::endl;
-  }else if(fun_name == "itos") {
+    std::cout << curr_val.to_string(); //<< std::endl;
+    break;
+  case ITOS_FUN:
     node.arg_list.front()->accept(*this);
     curr_val.set(curr_val.to_string());
-  }else if(fun_name == "stoi") {
+    break;
+  case STOI_FUN:
     node.arg_list.front()->accept(*this);
     curr_val.set(stoi(curr_val.to_string()));
-  }else if(fun_name == "stod") {
+    break;
+  case STOD_FUN:
     node.arg_list.front()->accept(*this);
     curr_val.set(stod(curr_val.to_string()));
-  }else if(fun_name == "dtos") { //for some reason this adds a trailing 0
+    break;
+  case DTOS_FUN: { //for some reason this adds a trailing 0
     node.arg_list.front()->accept(*this);
     std::string s =  curr_val.to_string();
     //remove trailing 0s
@@ -547,100 +559,115 @@ void Interpreter::visit(CallExpr& node) {
       }
     }
     curr_val.set(s);
-  }else if(fun_name == "length") {
+    break;
+  }
+  case LENGTH_FUN:
     node.arg_list.front()->accept(*this);
-    curr_val.set(curr_val.to_string().length());
-  }else if(fun_name == "get") {
+    curr_val.set((int)curr_val.to_string().length());
+    break;
+  case GET_FUN: {
     node.arg_list.front()->accept(*this);
     int i;
     curr_val.value(i);
-    node.arg_list.pop_front(); // CAREFUL WITH THIS, MESSES UP TREE FOR FUTURE USE.
-    node.arg_list.front()->accept(*this);
+    node.arg_list.back()->accept(*this);
     curr_val.set(curr_val.to_string().at(i));
-  }else if(fun_name == "read") {
+    break;
+  }
+  case READ_FUN: {
     std::string s;
     getline(std::cin, s);
     curr_val.set(s);
+    break;
   }
-  // etc , for  each  built in  function
-  else{
+  case USER_FUN: {
     // call  the  function
-    FunDecl* fun_node = functions[fun_name];
-    //    1.  evaluate  the  args  and  save
-    std::list<std::pair<std::string,DataObject>> args;
-    auto param = fun_node->params.begin();
-
-    //std::cout << "Function call: " << fun_name << " " << std::endl;
-    for(Expr* e : node.arg_list) {
-      e->accept(*this);
-      DataObject d;
-      d = curr_val;
-      args.push_back(std::pair<std::string,DataObject>(param->id.lexeme(),d));
-      //std::cout << param->id.lexeme() << "=" << d.to_string() << ", ";
-      param++;
+    FunDecl* fun_node = node.fun;
+    if(node.tail_call) {
+      //  nothing in this call runs afterwards, so leave the args on top
+      //  of the stack and unwind to the enclosing call, which runs the
+      //  function in its frame instead of nesting a new one
+      size_t top = slots.size();
+      slots.resize(top + node.arg_list.size());
+      for(size_t i = 0; i < node.arg_list.size(); ++i) {
+        node.arg_list[i]->accept(*this);
+        slots[top + i] = std::move(curr_val);
+      }
+      tail_fun = fun_node;
+      returning = true;
+      break;
     }
-    //std::cout << std::endl;
-
-    //    2. save  the  current  environment
-    int curr_environment = sym_table.get_environment_id();
-    //    3. go to the  gobal  environment
-    sym_table.set_environment_id(global_env_id);
-    //    4. push a new  environment
-    sym_table.push_environment();
-
-    //    5. add  param  values (from 1)
-    for(std::pair<std::string,DataObject> p : args) {
-      sym_table.add_name(p.first);
-      sym_table.set_val_info(p.first,p.second);
+    //    1. reserve the callee's frame on top of the stack (which
+    //       keeps its contents reachable for the collector)
+    size_t base = slots.size();
+    slots.resize(base + fun_node->frame_size);
+    //    2. evaluate the args straight into the parameter slots (any
+    //       calls they make use the stack above the new frame)
+    for(size_t i = 0; i < node.arg_list.size(); ++i) {
+      node.arg_list[i]->accept(*this);
+      slots[base + i] = std::move(curr_val);
     }
-    //std::cout << sym_table.to_string() << std::endl;
-    try{
-    //    6. eval  each  statement
-      for(Stmt* s : fun_node->stmts) {
-        s->accept(*this);
+    //       a memoized function that already ran with these args
+    //       returns the same value again
+    Memo* memo = nullptr;
+    std::string key;
+    if(!memos.empty()) {
+      auto m = memos.find(fun_node);
+      if(m != memos.end()) {
+        memo = &m->second;
+        memo_key(base, node.arg_list.size(), key);
+        auto result = memo->results.find(key);
+        if(result != memo->results.end()) {
+          ++memo->hits;
+          curr_val = result->second;
+          slots.resize(base);
+          break;
+        }
+        ++memo->misses;
       }
-    }catch(MyPLReturnException* e) {
-    //    7.  catch a return  exception
+    }
+    //    3. switch to the callee's frame
+    size_t caller_base = frame_base;
+    frame_base = base;
+    while(true) {
+      //    4. eval  each  statement (until a return)
+      exec_block(fun_node->stmts);
+      //    5.  the return (if any) stops here
+      returning = false;
+      if(!tail_fun) {
+        break;
+      }
+      //    6. a tail call replaces the frame: move its args into the
+      //       parameter slots and clear the rest for the new function
+      fun_node = tail_fun;
+      tail_fun = nullptr;
+      size_t args = fun_node->params.size();
+      size_t top = slots.size() - args;
+      for(size_t i = 0; top != base && i < args; ++i) {
+        slots[base + i] = std::move(slots[top + i]);
+      }
+      slots.resize(base + args);
+      slots.resize(base + fun_node->frame_size);
     }
     //std::cout << "called: " << fun_name << " Returned: " << curr_val.to_string() << std::endl;
-    //    8. pop  environment
-    sym_table.pop_environment();
-
-    //    9.  return  to  saved  environment
-    sym_table.set_environment_id(curr_environment);
-    
-    // ...
+    //    7. pop the frame
+    frame_base = caller_base;
+    slots.resize(base);
+    if(memo && memo->results.size() < memo_limit) {
+      memo->results.emplace(std::move(key), curr_val);
+    }
+    break;
+  }
   }
 }
 void Interpreter::visit(IDRValue& node) {
   //std::cout << "ID R Value "  << node.path.back().lexeme() << std::endl;
+  //traverse the path in place, only copying the final value
   auto t = node.path.begin();
-  DataObject d;
-  if(sym_table.has_val_info(t->lexeme())) {
-    sym_table.get_val_info(t->lexeme(),d);
-    //std::cout << "what " << d.to_string() << std::endl;
+  const DataObject* d = &variable(node.slot);
+  for(int offset : node.offsets) {
+    d = &object(*d,*t++).field(offset);
   }
-  //at this point d should hold an OID;
-  HeapObject ho;
-  //traverse call tree till final primative type
-  while ((t != --(node.path.end()) && d.is_oid())) {
-    
-    size_t oid;
-    d.value(oid);
-    //std::cout << oid << std::endl;
-    if(heap.has_obj(oid)) {
-      
-      heap.get_obj(oid,ho);
-      ho.get_val((++t)->lexeme(),d);
-    }
-  }
-  //check primative type
-  
-  //std::cout << "got here" << std::endl;
-  ho.get_val(t->lexeme(),d);
-  
-  curr_val = d;
- //std::cout << sym_table.to_string() << std::endl;
+  curr_val = *d;
 }
 void Interpreter::visit(NegatedRValue& node) {
   //probably did something wrong but this never gets called from what i can tell
@@ -0,0 +1,219 @@
+//----------------------------------------------------------------------
+// NAME: Brennan Longstreth
+// FILE: kernels.h
+// CONTRIBUTORS:
+// DATE: Fall 2026
+// DESC: Specialized implementations of the binary operators, one per
+//       operator and operand type (e.g., int+int or string<string).
+//       The type checker picks the kernel for each expression from its
+//       decoded operator and static operand types, so the interpreter
+//       evaluates an operator without any string or type tests.
+// NOTES: A kernel returns nullptr on success and the runtime error
+//        message otherwise. Values of a statically typed operand can
+//        still be nil at runtime, which every kernel checks for.
+//----------------------------------------------------------------------
+
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include <functional>
+#include <string>
+#include "data_object.h"
+
+
+// binary operators (decoded from the operator token)
+enum BinOp {BIN_NONE, BIN_ADD, BIN_SUB, BIN_MUL, BIN_DIV, BIN_MOD, BIN_AND,
+            BIN_OR, BIN_EQ, BIN_NE, BIN_LT, BIN_LE, BIN_GT, BIN_GE,
+            BIN_COUNT};
+
+// computes out = lhs op rhs
+typedef const char* (*Kernel)(const DataObject& lhs, const DataObject& rhs,
+                              DataObject& out);
+
+
+//----------------------------------------------------------------------
+// Kernel templates
+//----------------------------------------------------------------------
+
+// arithmetic, comparison, and logical operators over one type
+template<typename T, typename Op>
+const char* binary_kernel(const DataObject& lhs, const DataObject& rhs,
+                          DataObject& out)
+{
+  T l, r;
+  if (!lhs.value(l) or !rhs.value(r))
+    return "Expression term is nil";
+  out.set(Op()(l, r));
+  return nullptr;
+}
+
+
+// integer / and % (which must not divide by zero)
+template<typename Op>
+const char* int_division_kernel(const DataObject& lhs, const DataObject& rhs,
+                                DataObject& out)
+{
+  int l, r;
+  if (!lhs.value(l) or !rhs.value(r))
+    return "Expression term is nil";
+  if (r == 0)
+    return "division by zero";
+  out.set(Op()(l, r));
+  return nullptr;
+}
+
+
+// string + string, string + char, char + string, and char + char
+template<typename L, typename R>
+const char* concat_kernel(const DataObject& lhs, const DataObject& rhs,
+                          DataObject& out)
+{
+  L l;
+  R r;
+  if (!lhs.value(l) or !rhs.value(r))
+    return "Expression term is nil";
+  std::string s;
+  s += l;
+  s += r;
+  out.set(s);
+  return nullptr;
+}
+
+
+// == and != where either side may be nil (nil only equals nil)
+template<typename T, bool Equal>
+const char* equality_kernel(const DataObject& lhs, const DataObject& rhs,
+                            DataObject& out)
+{
+  T l, r;
+  if (!lhs.value(l) or !rhs.value(r))
+    out.set((lhs.is_nil() and rhs.is_nil()) == Equal);
+  else
+    out.set((l == r) == Equal);
+  return nullptr;
+}
+
+
+// nil is only equal to nil, otherwise both type and value must match
+template<typename T>
+bool same_value(const DataObject& lhs, const DataObject& rhs)
+{
+  T l, r;
+  lhs.value(l);
+  rhs.value(r);
+  return l == r;
+}
+
+bool values_equal(const DataObject& lhs, const DataObject& rhs)
+{
+  if (lhs.type() != rhs.type())
+    return false;
+  switch (lhs.type()) {
+    case DataObject::INTEGER: return same_value<int>(lhs, rhs);
+    case DataObject::DOUBLE: return same_value<double>(lhs, rhs);
+    case DataObject::STRING: return same_value<std::string>(lhs, rhs);
+    case DataObject::CHAR: return same_value<char>(lhs, rhs);
+    case DataObject::BOOL: return same_value<bool>(lhs, rhs);
+    case DataObject::OID: return same_value<size_t>(lhs, rhs);
+    case DataObject::NIL: return true;
+  }
+  return false;
+}
+
+
+// == and != when the left operand is the nil literal (or a variable
+// only known to be nil), so its runtime type is not fixed
+template<bool Equal>
+const char* nil_equality_kernel(const DataObject& lhs, const DataObject& rhs,
+                                DataObject& out)
+{
+  out.set(values_equal(lhs, rhs) == Equal);
+  return nullptr;
+}
+
+
+//----------------------------------------------------------------------
+// Kernel selection
+//----------------------------------------------------------------------
+
+#define INT_KERNEL(OP) binary_kernel<int,OP<int>>
+#define DBL_KERNEL(OP) binary_kernel<double,OP<double>>
+#define STR_KERNEL(OP) binary_kernel<std::string,OP<std::string>>
+#define CHR_KERNEL(OP) binary_kernel<char,OP<char>>
+#define EQ_KERNELS(EQ)                                                  \
+  {equality_kernel<int,EQ>, equality_kernel<double,EQ>,                 \
+   equality_kernel<std::string,EQ>, equality_kernel<char,EQ>,           \
+   equality_kernel<bool,EQ>, equality_kernel<size_t,EQ>,                \
+   nil_equality_kernel<EQ>}
+#define CMP_KERNELS(OP)                                                 \
+  {INT_KERNEL(OP), DBL_KERNEL(OP), STR_KERNEL(OP), CHR_KERNEL(OP),      \
+   nullptr, nullptr, nullptr}
+
+//----------------------------------------------------------------------
+// Get the kernel for an operator applied to the given static types.
+// Inputs:
+//   op -- the decoded operator
+//   lhs -- the static type of the left operand
+//   rhs -- the static type of the right operand
+// Returns:
+//   the kernel, or nullptr if the operator isn't defined for the types
+//----------------------------------------------------------------------
+Kernel select_kernel(BinOp op, DataObject::DataType lhs,
+                     DataObject::DataType rhs)
+{
+  // indexed by operator and left operand type (in DataType order:
+  // int, double, string, char, bool, oid, nil)
+  static const Kernel table[BIN_COUNT][7] = {
+    // none
+    {nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr},
+    // + (string and char concatenation is selected below)
+    {INT_KERNEL(std::plus), DBL_KERNEL(std::plus),
+     nullptr, nullptr, nullptr, nullptr, nullptr},
+    // -
+    {INT_KERNEL(std::minus), DBL_KERNEL(std::minus),
+     nullptr, nullptr, nullptr, nullptr, nullptr},
+    // *
+    {INT_KERNEL(std::multiplies), DBL_KERNEL(std::multiplies),
+     nullptr, nullptr, nullptr, nullptr, nullptr},
+    // /
+    {int_division_kernel<std::divides<int>>, DBL_KERNEL(std::divides),
+     nullptr, nullptr, nullptr, nullptr, nullptr},
+    // %
+    {int_division_kernel<std::modulus<int>>,
+     nullptr, nullptr, nullptr, nullptr, nullptr, nullptr},
+    // and
+    {nullptr, nullptr, nullptr, nullptr,
+     binary_kernel<bool,std::logical_and<bool>>, nullptr, nullptr},
+    // or
+    {nullptr, nullptr, nullptr, nullptr,
+     binary_kernel<bool,std::logical_or<bool>>, nullptr, nullptr},
+    // ==, !=
+    EQ_KERNELS(true),
+    EQ_KERNELS(false),
+    // <, <=, >, >=
+    CMP_KERNELS(std::less),
+    CMP_KERNELS(std::less_equal),
+    CMP_KERNELS(std::greater),
+    CMP_KERNELS(std::greater_equal)
+  };
+  // indexed by whether the left and right operands are chars
+  static const Kernel concat_table[2][2] = {
+    {concat_kernel<std::string,std::string>, concat_kernel<std::string,char>},
+    {concat_kernel<char,std::string>, concat_kernel<char,char>}
+  };
+  bool lhs_text = lhs == DataObject::STRING or lhs == DataObject::CHAR;
+  bool rhs_text = rhs == DataObject::STRING or rhs == DataObject::CHAR;
+  if (op == BIN_ADD and lhs_text and rhs_text)
+    return concat_table[lhs == DataObject::CHAR][rhs == DataObject::CHAR];
+  return table[op][lhs];
+}
+
+#undef INT_KERNEL
+#undef DBL_KERNEL
+#undef STR_KERNEL
+#undef CHR_KERNEL
+#undef EQ_KERNELS
+#undef CMP_KERNELS
+
+
+#endif
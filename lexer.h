@@ -5,33 +5,88 @@
 // DATE: 2/15/2020
 // DESC: Decides on which token to place in the token stream based on 
 //       input character stream
-// NOTES: 
+// NOTES: The lexer scans one contiguous buffer with a pointer: either
+//        a caller's buffer (e.g., a memory-mapped SourceFile) or a
+//        copy of an input stream. Lexemes are interned straight from
+//        the buffer, so a repeated lexeme is never copied.
 //----------------------------------------------------------------------
 
 #ifndef LEXER_H
 #define LEXER_H
 
+#include <cstring>
 #include <istream>
+#include <iterator>
+#include <memory>
 #include <string>
 #include "token.h"
 #include "mypl_exception.h"
 
 
+// a reserved word and its token type
+struct Keyword
+{
+  const char* text;
+  size_t length;
+  TokenType type;
+};
+
+// reserved words bucketed by first letter ('a' to 'z'); unused
+// entries have length 0 so they never match
+constexpr Keyword keyword_table[26][4] = {
+  /* a */ {{"and", 3, AND}},
+  /* b */ {{"bool", 4, BOOL_TYPE}},
+  /* c */ {{"char", 4, CHAR_TYPE}},
+  /* d */ {{"do", 2, DO}, {"double", 6, DOUBLE_TYPE}},
+  /* e */ {{"end", 3, END}, {"elseif", 6, ELSEIF}, {"else", 4, ELSE}},
+  /* f */ {{"fun", 3, FUN}, {"for", 3, FOR}, {"false", 5, BOOL_VAL}},
+  /* g */ {},
+  /* h */ {},
+  /* i */ {{"if", 2, IF}, {"int", 3, INT_TYPE}},
+  /* j */ {},
+  /* k */ {},
+  /* l */ {},
+  /* m */ {},
+  /* n */ {{"neg", 3, NEG}, {"new", 3, NEW}, {"nil", 3, NIL},
+           {"not", 3, NOT}},
+  /* o */ {{"or", 2, OR}},
+  /* p */ {},
+  /* q */ {},
+  /* r */ {{"return", 6, RETURN}},
+  /* s */ {{"string", 6, STRING_TYPE}},
+  /* t */ {{"type", 4, TYPE}, {"to", 2, TO}, {"then", 4, THEN},
+           {"true", 4, BOOL_VAL}},
+  /* u */ {},
+  /* v */ {{"var", 3, VAR}},
+  /* w */ {{"while", 5, WHILE}}
+};
+
+
 class Lexer
 {
 public:
 
-  // construct a new lexer from the input stream
+  // construct a new lexer from the input stream (which is read into
+  // a buffer up front)
   Lexer(std::istream& input_stream);
 
+  // construct a new lexer over the given characters (which must
+  // outlive the lexer and any copies of it)
+  Lexer(const char* begin, const char* end);
+
   // return the next available token in the input stream (including
   // EOS if at the end of the stream)
   Token next_token();
   
 private:
 
-  // input stream, current line, and current column
-  std::istream& input_stream;
+  // the buffer read from an input stream (shared by copies)
+  std::shared_ptr<const std::string> buffer;
+
+  // next character to scan, end of input, current line, and current
+  // column
+  const char* curr;
+  const char* last;
   int line;
   int column;
 
@@ -41,6 +96,9 @@ private:
   // return a single character from the input stream without advancing
   char peek();
 
+  // the reserved word type of the given word, or ID if it isn't one
+  TokenType keyword_type(const char* word, size_t length) const;
+
   // create and throw a mypl_exception (exits the lexer)
   void error(const std::string& msg, int line, int column) const;
 
@@ -48,7 +106,17 @@ private:
 
 
 Lexer::Lexer(std::istream& input_stream)
-  : input_stream(input_stream), line(1), column(0)
+  : buffer(std::make_shared<std::string>(
+      std::istreambuf_iterator<char>(input_stream),
+      std::istreambuf_iterator<char>())),
+    curr(buffer->data()), last(buffer->data() + buffer->size()),
+    line(1), column(0)
+{
+}
+
+
+Lexer::Lexer(const char* begin, const char* end)
+  : curr(begin), last(end), line(1), column(0)
 {
 }
 
@@ -56,13 +124,28 @@ Lexer::Lexer(std::istream& input_stream)
 char Lexer::read()
 {
   column++;
-  return input_stream.get();
+  if (curr == last)
+    return EOF;
+  return *curr++;
 }
 
 
 char Lexer::peek()
 {
-  return input_stream.peek();
+  if (curr == last)
+    return EOF;
+  return *curr;
+}
+
+
+TokenType Lexer::keyword_type(const char* word, size_t length) const
+{
+  if (*word < 'a' or *word > 'z')
+    return ID;
+  for (const Keyword& k : keyword_table[*word - 'a'])
+    if (k.length == length and std::memcmp(k.text, word, length) == 0)
+      return k.type;
+  return ID;
 }
 
 
@@ -74,7 +157,6 @@ void Lexer::error(const std::string& msg, int line, int column) const
 
 Token Lexer::next_token()
 {
-  std::string lexeme = "";
   char ch = read();
   
   //1 Read through white space 
@@ -87,9 +169,12 @@ Token Lexer::next_token()
       ch = read();
     }
     while(ch == '#') {
-      while(ch != '\n') {
+      while(ch != '\n' && ch != EOF) {
         ch = read();
       }
+      if(ch == EOF) {
+        return Token(EOS,"",line,column);
+      }
       column = 0;
       line++;
       ch = read();
@@ -185,81 +270,77 @@ Token Lexer::next_token()
   
   //5 check for char values
   if(ch == '\'') {
-    std::string temp = "";
-    temp += read();
+    const char* start = curr;
+    read();
     if(peek() == '\'') {
       read(); // removes end quote
     }else {
       error("Invalid ending character for char", l, c);
     }
-    return Token(CHAR_VAL,temp,l,c);
+    return Token(CHAR_VAL,start,curr - 1 - start,l,c);
   }
 
   //6 check for string values
   if(ch == '"') {
-    std::string temp = "";
+    const char* start = curr;
     while(peek() != '"') {
       if(peek() == '\n') {
         error("multiline strings are not allowed",l,c);
       }
-      temp += read();
+      if(peek() == EOF) {
+        error("missing ending quote in string",l,c);
+      }
+      read();
     }
+    const char* stop = curr;
     read(); // removes end quote
-    return Token(STRING_VAL,temp,l,c);
+    return Token(STRING_VAL,start,stop - start,l,c);
   }
 
   //7 check for numeric values
   if(isdigit(ch)) {
-    std::string temp = "";
-    temp += ch;
+    const char* start = curr - 1;
     while(isdigit(peek())){
-      ch = read();
-      temp += ch;
+      read();
     }
-    if(temp.length() > 1 && temp[0] == '0') {
+    if(curr - start > 1 && *start == '0') {
       error("leading 0 not allowed in this case",l,c);
     }
     if(peek() != '.') { // pulls out the integer case
-      return Token(INT_VAL,temp,l,c);
+      return Token(INT_VAL,start,curr - start,l,c);
     }
     
-    ch = read();
-    temp += ch;
+    read();
     if(!isdigit(peek())) {
       error("Needs at least one digit after '.' ",l,c);
     }
     while(isdigit(peek())){
-      ch = read();
-      temp += ch;
+      read();
     }
-    return Token(DOUBLE_VAL,temp,l,c);
+    return Token(DOUBLE_VAL,start,curr - start,l,c);
   }
 
   //8 check for reserved words
-  int KEYWORDS = 26;
-  std::string lex [KEYWORDS]= {"and", "bool", "char", "do", "double", "end", "elseif", "else", "fun", "for", "false", "if", "int", "neg", "new", "nil", "not", "or", "return", "string", "type", "to", "then", "true", "var", "while"};
-  TokenType tokenLookup [KEYWORDS] = {AND, BOOL_TYPE, CHAR_TYPE, DO, DOUBLE_TYPE, END, ELSEIF, ELSE, FUN, FOR, BOOL_VAL, IF, INT_TYPE, NEG, NEW, NIL, NOT, OR, RETURN, STRING_TYPE, TYPE, TO, THEN, BOOL_VAL, VAR, WHILE};
-  std::string temp = "";
-  temp += ch;
+  const char* start = curr - 1;
   while(isalpha(peek()) || isdigit(peek()) || peek() == '_') {
-    ch = read();
-    temp += ch;
+    read();
   }
+  size_t length = curr - start;
 
-  for(int i = 0; i < KEYWORDS; i++) {
-    if(!temp.compare(lex[i])) {
-      return Token(tokenLookup[i],temp,l,c);
-    }
+  TokenType type = keyword_type(start, length);
+  if(type != ID) {
+    return Token(type,start,length,l,c);
   }
 
   //return ID
-  if(temp[0] == '_') {
+  if(*start == '_') {
     error("Cannot start ID with _",l,c);
   }
-  if(temp[temp.length()-1] == '"') {
-    error("possible missing starting quote in string: " + temp,l,c);
+  if(start[length-1] == '"') {
+    error("possible missing starting quote in string: " +
+          std::string(start,curr),l,c);
   }
-  return Token(ID,temp,l,c);
+  return Token(ID,start,length,l,c);
 }
 
 #endif
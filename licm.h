@@ -0,0 +1,604 @@
+//----------------------------------------------------------------------
+// NAME: Brennan Longstreth
+// FILE: licm.h
+// CONTRIBUTORS:
+// DATE: Fall 2026
+// DESC: Loop-invariant code motion for while and for loops. An
+//       expression is invariant in a loop if it only reads variables
+//       the loop never assigns or declares, calls no functions other
+//       than the pure built-ins (itos, stoi, stod, dtos, length, get;
+//       print and read have effects), creates no objects, and reads
+//       fields only if the loop writes no fields and calls no
+//       functions. Invariant parts of a while condition are computed
+//       once before the loop. Invariant expressions in the body are
+//       computed the first time they are reached and kept in a
+//       variable declared before the loop (the statement first checks
+//       whether the variable is still nil), so a loop that never runs
+//       computes nothing and errors are raised exactly where they
+//       would have been.
+// NOTES: Runs after the optimizer (so constants are already folded)
+//        and before the resolver. Only the parts of a statement that
+//        run before anything that could fail or have an effect are
+//        hoisted, which keeps the order of output and errors. Body
+//        expressions must be worth the nil check (a built-in call or a
+//        few operators); the temporaries are named "_licmN".
+//----------------------------------------------------------------------
+
+#ifndef LICM_H
+#define LICM_H
+
+#include <iostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "ast.h"
+
+
+class LoopHoister : public Visitor
+{
+public:
+
+  // hoist only if enabled
+  LoopHoister(bool enabled);
+
+  // top-level
+  void visit(Program& node);
+  void visit(FunDecl& node);
+  void visit(TypeDecl& node);
+  // statements
+  void visit(VarDeclStmt& node);
+  void visit(AssignStmt& node);
+  void visit(ReturnStmt& node);
+  void visit(IfStmt& node);
+  void visit(WhileStmt& node);
+  void visit(ForStmt& node);
+  // expressions
+  void visit(Expr& node);
+  void visit(SimpleTerm& node);
+  void visit(ComplexTerm& node);
+  // rvalues
+  void visit(SimpleRValue& node);
+  void visit(NewRValue& node);
+  void visit(CallExpr& node);
+  void visit(IDRValue& node);
+  void visit(NegatedRValue& node);
+
+  // print what was hoisted
+  void print_report(std::ostream& out) const;
+
+private:
+
+  bool enabled;
+
+  // the program's node storage (for the temporaries)
+  Arena* arena = nullptr;
+
+  // what the loop being hoisted from changes: the variables it
+  // assigns or declares, and whether it may write fields
+  std::unordered_set<std::string> variant;
+  bool writes_fields = false;
+
+  // declarations to put in front of the loop, and the statements to
+  // put in front of the statement being scanned
+  std::vector<Stmt*> before_loop;
+  std::vector<Stmt*> before_stmt;
+
+  // whether hoisted values are computed in front of the loop (for
+  // its condition) or when first reached (in its body)
+  bool guarded = false;
+
+  // the nil checks added so far (not scanned again for inner loops)
+  std::unordered_set<Stmt*> checks;
+
+  // set by a statement visitor to replace the statement in its block
+  // with these statements
+  bool replaced = false;
+  std::vector<Stmt*> replacement;
+
+  // report counts
+  size_t hoisted = 0;
+  size_t loops = 0;
+
+  // helpers
+  void visit_block(std::vector<Stmt*>& stmts);
+  void hoist_loop(Stmt& loop, Expr* cond, std::vector<Stmt*>& body,
+                  const Token* loop_var);
+  void find_changes(const std::vector<Stmt*>& stmts);
+  void find_changes(Expr* expr);
+  void hoist_block(std::vector<Stmt*>& stmts);
+  void hoist_stmt(Stmt* stmt);
+  bool scan(Expr* expr);
+  bool scan(ExprTerm* term);
+  bool invariant(Expr* expr, int& weight);
+  bool invariant(RValue* rvalue, int& weight);
+  bool worth_hoisting(int weight) const;
+  Token hoist(Expr* expr);
+  IDRValue* temp_ref(const Token& id);
+  static bool pure_built_in(BuiltIn fun);
+};
+
+
+LoopHoister::LoopHoister(bool enabled)
+  : enabled(enabled)
+{
+}
+
+
+void LoopHoister::print_report(std::ostream& out) const
+{
+  out << "licm: " << hoisted << " expressions hoisted out of " << loops
+      << " loops" << std::endl;
+}
+
+
+// built-ins with no effect (whose result only depends on the args)
+bool LoopHoister::pure_built_in(BuiltIn fun)
+{
+  return fun == ITOS_FUN or fun == STOI_FUN or fun == STOD_FUN or
+    fun == DTOS_FUN or fun == LENGTH_FUN or fun == GET_FUN;
+}
+
+
+void LoopHoister::visit_block(std::vector<Stmt*>& stmts)
+{
+  std::vector<Stmt*> result;
+  result.reserve(stmts.size());
+  for (Stmt* s : stmts) {
+    replaced = false;
+    s->accept(*this);
+    if (replaced)
+      result.insert(result.end(), replacement.begin(), replacement.end());
+    else
+      result.push_back(s);
+    replaced = false;
+    replacement.clear();
+  }
+  stmts.swap(result);
+}
+
+
+// hoist what is invariant in the loop, replacing the loop with the
+// temporaries' declarations followed by the loop
+void LoopHoister::hoist_loop(Stmt& loop, Expr* cond,
+                             std::vector<Stmt*>& body,
+                             const Token* loop_var)
+{
+  variant.clear();
+  writes_fields = false;
+  if (loop_var)
+    variant.insert(loop_var->lexeme());
+  if (cond)
+    find_changes(cond);
+  find_changes(body);
+  before_loop.clear();
+  size_t count = hoisted;
+  if (cond) {
+    guarded = false;
+    before_stmt.clear();
+    scan(cond);
+    before_loop.swap(before_stmt);
+  }
+  guarded = true;
+  hoist_block(body);
+  if (hoisted > count)
+    ++loops;
+  // the loops in the body may have more to hoist (into their own
+  // temporaries)
+  std::vector<Stmt*> decls;
+  decls.swap(before_loop);
+  visit_block(body);
+  if (!decls.empty()) {
+    replaced = true;
+    replacement = decls;
+    replacement.push_back(&loop);
+  }
+}
+
+
+// the variables and fields the statements may change
+void LoopHoister::find_changes(const std::vector<Stmt*>& stmts)
+{
+  for (Stmt* stmt : stmts) {
+    if (VarDeclStmt* s = dynamic_cast<VarDeclStmt*>(stmt)) {
+      variant.insert(s->id.lexeme());
+      find_changes(s->expr);
+    }
+    else if (AssignStmt* s = dynamic_cast<AssignStmt*>(stmt)) {
+      if (s->lvalue_list.size() == 1)
+        variant.insert(s->lvalue_list.front().lexeme());
+      else
+        writes_fields = true;
+      find_changes(s->expr);
+    }
+    else if (ReturnStmt* s = dynamic_cast<ReturnStmt*>(stmt))
+      find_changes(s->expr);
+    else if (IfStmt* s = dynamic_cast<IfStmt*>(stmt)) {
+      find_changes(s->if_part->expr);
+      find_changes(s->if_part->stmts);
+      for (BasicIf* b : s->else_ifs) {
+        find_changes(b->expr);
+        find_changes(b->stmts);
+      }
+      find_changes(s->body_stmts);
+    }
+    else if (WhileStmt* s = dynamic_cast<WhileStmt*>(stmt)) {
+      find_changes(s->expr);
+      find_changes(s->stmts);
+    }
+    else if (ForStmt* s = dynamic_cast<ForStmt*>(stmt)) {
+      variant.insert(s->var_id.lexeme());
+      find_changes(s->start);
+      find_changes(s->end);
+      find_changes(s->stmts);
+    }
+    else if (CallExpr* s = dynamic_cast<CallExpr*>(stmt)) {
+      if (built_in_named(s->function_id.lexeme()) == USER_FUN)
+        writes_fields = true;
+      for (Expr* e : s->arg_list)
+        find_changes(e);
+    }
+  }
+}
+
+
+// functions called and objects created may write fields
+void LoopHoister::find_changes(Expr* expr)
+{
+  if (!expr)
+    return;
+  if (ComplexTerm* ct = dynamic_cast<ComplexTerm*>(expr->first))
+    find_changes(ct->expr);
+  else {
+    RValue* r = static_cast<SimpleTerm*>(expr->first)->rvalue;
+    if (CallExpr* c = dynamic_cast<CallExpr*>(r)) {
+      if (built_in_named(c->function_id.lexeme()) == USER_FUN)
+        writes_fields = true;
+      for (Expr* e : c->arg_list)
+        find_changes(e);
+    }
+    else if (dynamic_cast<NewRValue*>(r))
+      writes_fields = true;
+    else if (NegatedRValue* n = dynamic_cast<NegatedRValue*>(r))
+      find_changes(n->expr);
+  }
+  find_changes(expr->rest);
+}
+
+
+void LoopHoister::hoist_block(std::vector<Stmt*>& stmts)
+{
+  std::vector<Stmt*> result;
+  result.reserve(stmts.size());
+  for (Stmt* s : stmts) {
+    before_stmt.clear();
+    if (!checks.count(s))
+      hoist_stmt(s);
+    result.insert(result.end(), before_stmt.begin(), before_stmt.end());
+    result.push_back(s);
+  }
+  stmts.swap(result);
+}
+
+
+// hoist from the parts of the statement that run first, then from the
+// blocks it contains
+void LoopHoister::hoist_stmt(Stmt* stmt)
+{
+  if (VarDeclStmt* s = dynamic_cast<VarDeclStmt*>(stmt))
+    scan(s->expr);
+  else if (AssignStmt* s = dynamic_cast<AssignStmt*>(stmt))
+    scan(s->expr);
+  else if (ReturnStmt* s = dynamic_cast<ReturnStmt*>(stmt))
+    scan(s->expr);
+  else if (CallExpr* s = dynamic_cast<CallExpr*>(stmt)) {
+    for (Expr* e : s->arg_list)
+      if (!scan(e))
+        break;
+  }
+  else if (IfStmt* s = dynamic_cast<IfStmt*>(stmt)) {
+    // later conditions may not run
+    std::vector<Stmt*> pending;
+    scan(s->if_part->expr);
+    pending.swap(before_stmt);
+    hoist_block(s->if_part->stmts);
+    for (BasicIf* b : s->else_ifs)
+      hoist_block(b->stmts);
+    hoist_block(s->body_stmts);
+    before_stmt.swap(pending);
+  }
+  else if (WhileStmt* s = dynamic_cast<WhileStmt*>(stmt)) {
+    std::vector<Stmt*> pending;
+    scan(s->expr);
+    pending.swap(before_stmt);
+    hoist_block(s->stmts);
+    before_stmt.swap(pending);
+  }
+  else if (ForStmt* s = dynamic_cast<ForStmt*>(stmt)) {
+    std::vector<Stmt*> pending;
+    if (scan(s->start))
+      scan(s->end);
+    pending.swap(before_stmt);
+    hoist_block(s->stmts);
+    before_stmt.swap(pending);
+  }
+}
+
+
+// hoist the invariant parts of the expression that run before anything
+// that can fail or has an effect, returning true if nothing evaluated
+// in the expression can
+bool LoopHoister::scan(Expr* expr)
+{
+  if (!expr)
+    return true;
+  int weight = 0;
+  if (invariant(expr, weight) and worth_hoisting(weight)) {
+    hoist(expr);
+    return true;
+  }
+  if (!scan(expr->first))
+    return false;
+  if (!expr->op)
+    return true;
+  // the rest of and/or may not run
+  if (expr->bin_op == BIN_AND or expr->bin_op == BIN_OR)
+    return false;
+  scan(expr->rest);
+  // the operator itself can fail (e.g., on a nil operand)
+  return false;
+}
+
+
+bool LoopHoister::scan(ExprTerm* term)
+{
+  if (ComplexTerm* ct = dynamic_cast<ComplexTerm*>(term))
+    return scan(ct->expr);
+  RValue* r = static_cast<SimpleTerm*>(term)->rvalue;
+  if (dynamic_cast<SimpleRValue*>(r))
+    return true;
+  int weight = 0;
+  if (invariant(r, weight) and worth_hoisting(weight)) {
+    Expr* e = arena->make<Expr>();
+    SimpleTerm* t = arena->make<SimpleTerm>();
+    t->rvalue = r;
+    e->first = t;
+    static_cast<SimpleTerm*>(term)->rvalue = temp_ref(hoist(e));
+    return true;
+  }
+  if (IDRValue* id = dynamic_cast<IDRValue*>(r))
+    return id->offsets.empty();
+  if (CallExpr* call = dynamic_cast<CallExpr*>(r))
+    for (Expr* e : call->arg_list)
+      if (!scan(e))
+        break;
+  return false;
+}
+
+
+// true if the expression has the same value in every iteration (and
+// adds up how much work it is)
+bool LoopHoister::invariant(Expr* expr, int& weight)
+{
+  bool result;
+  if (ComplexTerm* ct = dynamic_cast<ComplexTerm*>(expr->first))
+    result = invariant(ct->expr, weight);
+  else
+    result = invariant(static_cast<SimpleTerm*>(expr->first)->rvalue,
+                       weight);
+  if (expr->op) {
+    ++weight;
+    result = invariant(expr->rest, weight) and result;
+  }
+  return result;
+}
+
+
+bool LoopHoister::invariant(RValue* rvalue, int& weight)
+{
+  if (dynamic_cast<SimpleRValue*>(rvalue))
+    return true;
+  if (IDRValue* r = dynamic_cast<IDRValue*>(rvalue)) {
+    weight += r->offsets.size();
+    return !variant.count(r->path.front().lexeme()) and
+      (r->offsets.empty() or !writes_fields);
+  }
+  if (CallExpr* r = dynamic_cast<CallExpr*>(rvalue)) {
+    // built-in calls convert or copy strings
+    weight += 3;
+    bool result = pure_built_in(built_in_named(r->function_id.lexeme()));
+    for (Expr* e : r->arg_list)
+      result = invariant(e, weight) and result;
+    return result;
+  }
+  return false;
+}
+
+
+// a value computed before the loop is worth any work; one computed in
+// the body has to save more than the nil check costs
+bool LoopHoister::worth_hoisting(int weight) const
+{
+  return guarded ? weight >= 3 : weight >= 1;
+}
+
+
+// move the expression into a temporary (computed in front of the loop,
+// or when first reached) and read the temporary in its place,
+// returning the temporary's name
+Token LoopHoister::hoist(Expr* expr)
+{
+  ++hoisted;
+  const Token& pos = expr->first_token();
+  Token id(ID, "_licm" + std::to_string(hoisted), pos.line(), pos.column());
+  Expr* value = arena->make<Expr>(*expr);
+  VarDeclStmt* decl = arena->make<VarDeclStmt>();
+  decl->id = id;
+  decl->expr = value;
+  if (guarded) {
+    // declared nil, then set by the first statement that needs it:
+    // if _licmN == nil then _licmN = value end
+    SimpleRValue* nil = arena->make<SimpleRValue>();
+    nil->value = Token(NIL, "nil", pos.line(), pos.column());
+    SimpleTerm* nil_term = arena->make<SimpleTerm>();
+    nil_term->rvalue = nil;
+    Expr* nil_expr = arena->make<Expr>();
+    nil_expr->first = nil_term;
+    decl->expr = nil_expr;
+    Expr* test = arena->make<Expr>();
+    SimpleTerm* lhs = arena->make<SimpleTerm>();
+    lhs->rvalue = temp_ref(id);
+    test->first = lhs;
+    test->op = arena->make<Token>(EQUAL, "==", pos.line(), pos.column());
+    Expr* rest = arena->make<Expr>();
+    SimpleTerm* rhs = arena->make<SimpleTerm>();
+    rhs->rvalue = nil;
+    rest->first = rhs;
+    test->rest = rest;
+    test->bin_op = BIN_EQ;
+    test->lhs_type = DataObject::NIL;
+    test->rhs_type = DataObject::NIL;
+    test->kernel = select_kernel(BIN_EQ, DataObject::NIL, DataObject::NIL);
+    AssignStmt* set = arena->make<AssignStmt>();
+    set->lvalue_list.push_back(id);
+    set->expr = value;
+    IfStmt* check = arena->make<IfStmt>();
+    check->if_part = arena->make<BasicIf>();
+    check->if_part->expr = test;
+    check->if_part->stmts.push_back(set);
+    checks.insert(check);
+    before_stmt.push_back(check);
+    before_loop.push_back(decl);
+  }
+  else
+    before_stmt.push_back(decl);
+  // the expression now just reads the temporary
+  SimpleTerm* t = arena->make<SimpleTerm>();
+  t->rvalue = temp_ref(id);
+  expr->first = t;
+  expr->op = nullptr;
+  expr->rest = nullptr;
+  expr->negated = false;
+  expr->bin_op = BIN_NONE;
+  expr->kernel = nullptr;
+  return id;
+}
+
+
+IDRValue* LoopHoister::temp_ref(const Token& id)
+{
+  IDRValue* r = arena->make<IDRValue>();
+  r->path.push_back(id);
+  return r;
+}
+
+
+//----------------------------------------------------------------------
+// TOP-LEVEL
+//----------------------------------------------------------------------
+
+void LoopHoister::visit(Program& node)
+{
+  if (!enabled)
+    return;
+  arena = &node.arena;
+  for (Decl* d : node.decls)
+    d->accept(*this);
+}
+
+
+void LoopHoister::visit(FunDecl& node)
+{
+  visit_block(node.stmts);
+}
+
+
+void LoopHoister::visit(TypeDecl&)
+{
+}
+
+
+//----------------------------------------------------------------------
+// STATEMENTS (only loops and the blocks that may contain them)
+//----------------------------------------------------------------------
+
+void LoopHoister::visit(VarDeclStmt&)
+{
+}
+
+
+void LoopHoister::visit(AssignStmt&)
+{
+}
+
+
+void LoopHoister::visit(ReturnStmt&)
+{
+}
+
+
+void LoopHoister::visit(IfStmt& node)
+{
+  visit_block(node.if_part->stmts);
+  for (BasicIf* b : node.else_ifs)
+    visit_block(b->stmts);
+  visit_block(node.body_stmts);
+}
+
+
+void LoopHoister::visit(WhileStmt& node)
+{
+  hoist_loop(node, node.expr, node.stmts, nullptr);
+}
+
+
+void LoopHoister::visit(ForStmt& node)
+{
+  hoist_loop(node, nullptr, node.stmts, &node.var_id);
+}
+
+
+//----------------------------------------------------------------------
+// EXPRESSIONS AND RVALUES (nothing to do)
+//----------------------------------------------------------------------
+
+void LoopHoister::visit(Expr&)
+{
+}
+
+
+void LoopHoister::visit(SimpleTerm&)
+{
+}
+
+
+void LoopHoister::visit(ComplexTerm&)
+{
+}
+
+
+void LoopHoister::visit(SimpleRValue&)
+{
+}
+
+
+void LoopHoister::visit(NewRValue&)
+{
+}
+
+
+void LoopHoister::visit(CallExpr&)
+{
+}
+
+
+void LoopHoister::visit(IDRValue&)
+{
+}
+
+
+void LoopHoister::visit(NegatedRValue&)
+{
+}
+
+
+#endif
@@ -0,0 +1,488 @@
+//----------------------------------------------------------------------
+// NAME: Brennan Longstreth
+// FILE: optimizer.h
+// CONTRIBUTORS:
+// DATE: Fall 2026
+// DESC: AST optimizations that run between the type checker and the
+//       resolver. At level 1 constant subexpressions are folded into
+//       literals (using the same kernels the interpreter runs, so the
+//       results are identical). Level 2 also removes dead code: if and
+//       else-if branches whose condition is constant, while loops whose
+//       condition is false, and statements after a return.
+// NOTES: An operation that would fail at runtime (e.g., division by
+//        zero) is left alone so it still fails when executed. A branch
+//        that is always taken replaces its if statement only when its
+//        body declares no variables (so it can't clash with the
+//        enclosing scope).
+//----------------------------------------------------------------------
+
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "ast.h"
+
+
+class Optimizer : public Visitor
+{
+public:
+
+  // optimize at the given level (0 does nothing)
+  Optimizer(int level);
+
+  // top-level
+  void visit(Program& node);
+  void visit(FunDecl& node);
+  void visit(TypeDecl& node);
+  // statements
+  void visit(VarDeclStmt& node);
+  void visit(AssignStmt& node);
+  void visit(ReturnStmt& node);
+  void visit(IfStmt& node);
+  void visit(WhileStmt& node);
+  void visit(ForStmt& node);
+  // expressions
+  void visit(Expr& node);
+  void visit(SimpleTerm& node);
+  void visit(ComplexTerm& node);
+  // rvalues
+  void visit(SimpleRValue& node);
+  void visit(NewRValue& node);
+  void visit(CallExpr& node);
+  void visit(IDRValue& node);
+  void visit(NegatedRValue& node);
+
+  // print what was folded and removed
+  void print_report(std::ostream& out) const;
+
+private:
+
+  int level;
+
+  // the program's node storage (for new literals)
+  Arena* arena = nullptr;
+
+  // set by the expression visitors: whether the last expression, term,
+  // or rvalue visited is a constant, and if so its value
+  bool is_const = false;
+  DataObject const_val;
+
+  // set by a statement visitor to replace the statement in its block
+  // with these statements (none removes it)
+  bool replaced = false;
+  std::vector<Stmt*> replacement;
+
+  // report counts
+  size_t folded_exprs = 0;
+  size_t pruned_branches = 0;
+  size_t removed_loops = 0;
+  size_t removed_stmts = 0;
+
+  // helpers
+  void optimize_block(std::vector<Stmt*>& stmts);
+  void replace_with(std::vector<Stmt*>& stmts);
+  bool const_condition(Expr* expr, bool& val);
+  bool literal_token(const DataObject& val, const Token& pos, Token& token);
+  Expr* true_expr(const Token& pos);
+  static bool is_literal(const Expr& expr);
+};
+
+
+Optimizer::Optimizer(int level)
+  : level(level)
+{
+}
+
+
+void Optimizer::print_report(std::ostream& out) const
+{
+  out << "optimizer (level " << level << "): "
+      << folded_exprs << " expressions folded, "
+      << pruned_branches << " branches pruned, "
+      << removed_loops << " loops removed, "
+      << removed_stmts << " unreachable statements removed" << std::endl;
+}
+
+
+// a plain literal (nothing left to fold)
+bool Optimizer::is_literal(const Expr& expr)
+{
+  SimpleTerm* t = dynamic_cast<SimpleTerm*>(expr.first);
+  return !expr.op and !expr.negated and t and
+    dynamic_cast<SimpleRValue*>(t->rvalue);
+}
+
+
+// the source token for a constant (false if it has no MyPL spelling,
+// which the printer needs)
+bool Optimizer::literal_token(const DataObject& val, const Token& pos,
+                              Token& token)
+{
+  std::string lexeme;
+  TokenType type;
+  if (val.is_integer()) {
+    int v;
+    val.value(v);
+    lexeme = std::to_string(v);
+    type = INT_VAL;
+  }
+  else if (val.is_double()) {
+    double v;
+    val.value(v);
+    if (!std::isfinite(v))
+      return false;
+    std::ostringstream s;
+    s.precision(17);
+    s << v;
+    lexeme = s.str();
+    if (lexeme.find_first_of(".e") == std::string::npos)
+      lexeme += ".0";
+    type = DOUBLE_VAL;
+  }
+  else if (val.is_string()) {
+    std::string v;
+    val.value(v);
+    // \n and \t are written back as escapes; strings that would need
+    // any other escaping are left unfolded
+    for (char c : v) {
+      if (c == '\\' or c == '"')
+        return false;
+      if (c == '\n')
+        lexeme += "\\n";
+      else if (c == '\t')
+        lexeme += "\\t";
+      else
+        lexeme += c;
+    }
+    type = STRING_VAL;
+  }
+  else if (val.is_bool()) {
+    bool v;
+    val.value(v);
+    lexeme = v ? "true" : "false";
+    type = BOOL_VAL;
+  }
+  else if (val.is_nil()) {
+    lexeme = "nil";
+    type = NIL;
+  }
+  else
+    return false;
+  token = Token(type, lexeme, pos.line(), pos.column());
+  return true;
+}
+
+
+// a literal true condition (for a branch that is always taken)
+Expr* Optimizer::true_expr(const Token& pos)
+{
+  SimpleRValue* r = arena->make<SimpleRValue>();
+  r->value = Token(BOOL_VAL, "true", pos.line(), pos.column());
+  r->literal.set(true);
+  SimpleTerm* t = arena->make<SimpleTerm>();
+  t->rvalue = r;
+  Expr* e = arena->make<Expr>();
+  e->first = t;
+  return e;
+}
+
+
+// fold the condition, returning true if it is a constant bool
+bool Optimizer::const_condition(Expr* expr, bool& val)
+{
+  expr->accept(*this);
+  return is_const and const_val.is_bool() and const_val.value(val);
+}
+
+
+void Optimizer::replace_with(std::vector<Stmt*>& stmts)
+{
+  replaced = true;
+  replacement = stmts;
+}
+
+
+void Optimizer::optimize_block(std::vector<Stmt*>& stmts)
+{
+  std::vector<Stmt*> result;
+  result.reserve(stmts.size());
+  for (size_t i = 0; i < stmts.size(); ++i) {
+    replaced = false;
+    stmts[i]->accept(*this);
+    if (replaced)
+      result.insert(result.end(), replacement.begin(), replacement.end());
+    else
+      result.push_back(stmts[i]);
+    replaced = false;
+    replacement.clear();
+    // nothing after a return runs (including one spliced in from an
+    // if statement that was always taken)
+    if (level >= 2 and !result.empty() and
+        dynamic_cast<ReturnStmt*>(result.back())) {
+      removed_stmts += stmts.size() - i - 1;
+      break;
+    }
+  }
+  stmts.swap(result);
+}
+
+
+//----------------------------------------------------------------------
+// TOP-LEVEL
+//----------------------------------------------------------------------
+
+void Optimizer::visit(Program& node)
+{
+  if (level <= 0)
+    return;
+  arena = &node.arena;
+  for (Decl* d : node.decls)
+    d->accept(*this);
+}
+
+
+void Optimizer::visit(FunDecl& node)
+{
+  optimize_block(node.stmts);
+}
+
+
+void Optimizer::visit(TypeDecl& node)
+{
+  for (VarDeclStmt* v : node.vdecls)
+    v->accept(*this);
+}
+
+
+//----------------------------------------------------------------------
+// STATEMENTS
+//----------------------------------------------------------------------
+
+void Optimizer::visit(VarDeclStmt& node)
+{
+  node.expr->accept(*this);
+}
+
+
+void Optimizer::visit(AssignStmt& node)
+{
+  node.expr->accept(*this);
+}
+
+
+void Optimizer::visit(ReturnStmt& node)
+{
+  if (node.expr)
+    node.expr->accept(*this);
+}
+
+
+void Optimizer::visit(IfStmt& node)
+{
+  std::vector<BasicIf*> branches;
+  branches.push_back(node.if_part);
+  branches.insert(branches.end(), node.else_ifs.begin(), node.else_ifs.end());
+  // the branches that may run, and the body that runs if none do
+  std::vector<BasicIf*> kept;
+  std::vector<Stmt*>* otherwise = &node.body_stmts;
+  bool always = false;
+  for (BasicIf* b : branches) {
+    bool val;
+    bool known = const_condition(b->expr, val);
+    optimize_block(b->stmts);
+    if (level < 2 or always or (known and !val))
+      continue;
+    if (known and val) {
+      // later branches and the else body can't run
+      otherwise = &b->stmts;
+      always = true;
+    }
+    else
+      kept.push_back(b);
+  }
+  optimize_block(node.body_stmts);
+  if (level < 2)
+    return;
+  if (kept.size() == branches.size())
+    return;
+  // every dropped branch except the one always taken, plus the else
+  // body if it can no longer run
+  pruned_branches += branches.size() - kept.size() - always;
+  if (always and !node.body_stmts.empty())
+    ++pruned_branches;
+  if (!kept.empty()) {
+    node.if_part = kept.front();
+    node.else_ifs.assign(kept.begin() + 1, kept.end());
+    if (otherwise != &node.body_stmts)
+      node.body_stmts = *otherwise;
+    return;
+  }
+  // no condition is left to test, so only the chosen body remains
+  bool declares = false;
+  for (Stmt* s : *otherwise)
+    if (dynamic_cast<VarDeclStmt*>(s))
+      declares = true;
+  if (!declares) {
+    std::vector<Stmt*> body = *otherwise;
+    replace_with(body);
+  }
+  else {
+    BasicIf* b = arena->make<BasicIf>();
+    b->expr = true_expr(node.if_part->expr->first_token());
+    b->stmts = *otherwise;
+    node.if_part = b;
+    node.else_ifs.clear();
+    node.body_stmts.clear();
+  }
+}
+
+
+void Optimizer::visit(WhileStmt& node)
+{
+  bool val;
+  if (const_condition(node.expr, val) and !val and level >= 2) {
+    ++removed_loops;
+    std::vector<Stmt*> none;
+    replace_with(none);
+    return;
+  }
+  optimize_block(node.stmts);
+}
+
+
+void Optimizer::visit(ForStmt& node)
+{
+  node.start->accept(*this);
+  node.end->accept(*this);
+  optimize_block(node.stmts);
+}
+
+
+//----------------------------------------------------------------------
+// EXPRESSIONS
+//----------------------------------------------------------------------
+
+void Optimizer::visit(Expr& node)
+{
+  node.first->accept(*this);
+  // unwrap parentheses around a literal
+  ComplexTerm* ct = dynamic_cast<ComplexTerm*>(node.first);
+  if (ct and is_literal(*ct->expr))
+    node.first = ct->expr->first;
+  bool first_const = is_const;
+  DataObject lhs = const_val;
+  bool decides;
+  if (first_const and (node.bin_op == BIN_AND or node.bin_op == BIN_OR) and
+      lhs.value(decides) and decides == (node.bin_op == BIN_OR)) {
+    // the rest is never evaluated
+    is_const = true;
+    const_val = lhs;
+  }
+  else if (node.op) {
+    node.rest->accept(*this);
+    bool rest_const = is_const;
+    is_const = false;
+    if (!first_const or !rest_const or !node.kernel)
+      return;
+    DataObject result;
+    // leave an error for runtime
+    if (node.kernel(lhs, const_val, result))
+      return;
+    is_const = true;
+    const_val = result;
+  }
+  else {
+    is_const = first_const;
+    const_val = lhs;
+  }
+  if (!is_const)
+    return;
+  if (node.negated) {
+    bool b;
+    int i;
+    double d;
+    if (const_val.value(b))
+      const_val.set(!b);
+    else if (const_val.value(i))
+      const_val.set(i * -1);
+    else if (const_val.value(d))
+      const_val.set(d * -1);
+  }
+  if (is_literal(node))
+    return;
+  // replace the whole expression with the literal
+  Token token;
+  if (!literal_token(const_val, node.first_token(), token)) {
+    is_const = false;
+    return;
+  }
+  SimpleRValue* r = arena->make<SimpleRValue>();
+  r->value = token;
+  r->literal = const_val;
+  SimpleTerm* t = arena->make<SimpleTerm>();
+  t->rvalue = r;
+  node.first = t;
+  node.op = nullptr;
+  node.rest = nullptr;
+  node.negated = false;
+  node.bin_op = BIN_NONE;
+  node.kernel = nullptr;
+  ++folded_exprs;
+}
+
+
+void Optimizer::visit(SimpleTerm& node)
+{
+  node.rvalue->accept(*this);
+}
+
+
+void Optimizer::visit(ComplexTerm& node)
+{
+  node.expr->accept(*this);
+}
+
+
+//----------------------------------------------------------------------
+// RVALUES
+//----------------------------------------------------------------------
+
+void Optimizer::visit(SimpleRValue& node)
+{
+  is_const = true;
+  const_val = node.literal;
+}
+
+
+void Optimizer::visit(NewRValue&)
+{
+  is_const = false;
+}
+
+
+void Optimizer::visit(CallExpr& node)
+{
+  for (Expr* e : node.arg_list)
+    e->accept(*this);
+  is_const = false;
+}
+
+
+void Optimizer::visit(IDRValue&)
+{
+  is_const = false;
+}
+
+
+void Optimizer::visit(NegatedRValue& node)
+{
+  node.expr->accept(*this);
+  is_const = false;
+}
+
+
+#endif
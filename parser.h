@@ -29,6 +29,9 @@ private:
   Lexer lexer;
   Token curr_token;
 
+  // where the nodes are allocated (the program being parsed)
+  Arena* arena = nullptr;
+
   bool _debug = false;
   
   // helper functions
@@ -44,8 +47,8 @@ private:
   //void vdecls(); //
   void params(FunDecl& node); //
   Token dtype(); //
-  void stmts(std::list<Stmt*>& s); //
-  bool stmt(std::list<Stmt*>& s); //
+  void stmts(std::vector<Stmt*>& s); //
+  bool stmt(std::vector<Stmt*>& s); //
 
   void vdecl_stmt(VarDeclStmt& node); //
 
@@ -60,7 +63,7 @@ private:
   void for_stmt(ForStmt& node);
 
   void call_expr(CallExpr& node);
-  void args(std::list<Expr*>& e);
+  void args(std::vector<Expr*>& e);
 
   void exit_stmt(ReturnStmt& node);
   void expr(Expr& e);
@@ -119,14 +122,15 @@ bool Parser::is_operator(TokenType t)
 void Parser::parse(Program& prog)
 {
   if(_debug)std::cout << "Starting Parser" << std::endl;
+  arena = &prog.arena;
   advance();
   while (curr_token.type() != EOS) {
     if (curr_token.type() == TYPE) {
-      TypeDecl* d = new TypeDecl;
+      TypeDecl* d = arena->make<TypeDecl>();
       tdecl(*d);
       prog.decls.push_back(d);
     }else{
-      FunDecl* d = new FunDecl;
+      FunDecl* d = arena->make<FunDecl>();
       fdecl(*d);
       prog.decls.push_back(d);
     }      
@@ -141,13 +145,11 @@ void Parser::tdecl(TypeDecl& node)
   node.id = curr_token;
   eat(ID, "expecting ID ");
   //replaces vdecls recursion to allow for loop definition outside of vdecl_stmt()
-  std::list<VarDeclStmt*>* vs = new std::list<VarDeclStmt*>();
   while(curr_token.type() == VAR) {
-    VarDeclStmt* vd = new VarDeclStmt;
+    VarDeclStmt* vd = arena->make<VarDeclStmt>();
     vdecl_stmt(*vd);
-    vs->push_back(vd);
+    node.vdecls.push_back(vd);
   }
-  node.vdecls = *vs;
   eat(END, "Expecting 'end' ");
 }
 
@@ -190,7 +192,6 @@ void Parser::params(FunDecl& node) {
 Token Parser::dtype() { 
   TokenType t = curr_token.type();
   if(t == INT_TYPE || t == DOUBLE_TYPE || t == BOOL_TYPE || t == CHAR_TYPE || t == STRING_TYPE || t == ID) {
-    Token t = curr_token;
     advance();
   }else {
     error("expecting primative type ");
@@ -198,17 +199,17 @@ Token Parser::dtype() {
   return curr_token;
 }
 
-void Parser::stmts(std::list<Stmt*>& s) {
+void Parser::stmts(std::vector<Stmt*>& s) {
   if(stmt(s)) {
     stmts(s);
   }
   //empty
 }
 
-bool Parser::stmt(std::list<Stmt*>& s) {
+bool Parser::stmt(std::vector<Stmt*>& s) {
   switch(curr_token.type()) {
     case VAR: {
-      VarDeclStmt* v = new VarDeclStmt;
+      VarDeclStmt* v = arena->make<VarDeclStmt>();
       vdecl_stmt(*v); 
       s.push_back(v);
       }
@@ -217,12 +218,12 @@ bool Parser::stmt(std::list<Stmt*>& s) {
       Token temp = curr_token; //saves ID
       advance(); //REMEMBER: for call and lvalue first token is already used;
       if(curr_token.type() == LPAREN) {
-        CallExpr* c = new CallExpr;
+        CallExpr* c = arena->make<CallExpr>();
         c->function_id = temp;
         call_expr(*c);
         s.push_back(c);
       }else if(curr_token.type() == ASSIGN || curr_token.type() == DOT) {
-        AssignStmt* a = new AssignStmt;
+        AssignStmt* a = arena->make<AssignStmt>();
         a->lvalue_list.push_back(temp);
         assign_stmt(*a);
         s.push_back(a);
@@ -232,25 +233,25 @@ bool Parser::stmt(std::list<Stmt*>& s) {
       break;
     }//assign statement/call expression
     case IF: {
-        IfStmt* i = new IfStmt();
+        IfStmt* i = arena->make<IfStmt>();
         cond_stmt(*i); 
         s.push_back(i);
       }
       break;//cond statement
     case WHILE: {
-        WhileStmt* w = new WhileStmt();
+        WhileStmt* w = arena->make<WhileStmt>();
         while_stmt(*w);
         s.push_back(w);
       }
       break;//while statement
     case FOR: {
-        ForStmt* f = new ForStmt();
+        ForStmt* f = arena->make<ForStmt>();
         for_stmt(*f); 
         s.push_back(f);
       }
       break;//for statement
     case RETURN: {
-        ReturnStmt* r = new ReturnStmt();
+        ReturnStmt* r = arena->make<ReturnStmt>();
         exit_stmt(*r); 
         s.push_back(r);
       }
@@ -266,16 +267,14 @@ void Parser::vdecl_stmt(VarDeclStmt& node) {
   eat(ID, "expecting ID ");
   if(curr_token.type() == COLON) {
     advance(); //already checked colon
-    Token* temp = new Token(); 
-    *temp = curr_token;
-    node.type = temp;
+    node.type = arena->make<Token>(curr_token);
     //if(_debug) std::cout << node.type->lexeme() << std::endl;
     dtype();
   }else if(curr_token.type() != ASSIGN) {
     error("expecting COLON or '=' ");
   }
   eat(ASSIGN, "expecting '=' ");
-  Expr* e = new Expr();
+  Expr* e = arena->make<Expr>();
   expr(*e);
   node.expr = e;
 }
@@ -284,7 +283,7 @@ void Parser::assign_stmt(AssignStmt& node) {
   //ID already taken
   lvalue(node);
   eat(ASSIGN, "expecting '=' ");
-  Expr* e = new Expr();
+  Expr* e = arena->make<Expr>();
   expr(*e);
   node.expr = e;
 }
@@ -301,8 +300,8 @@ void Parser::lvalue(AssignStmt& node) {
 
 void Parser::cond_stmt(IfStmt& node) {
   advance(); //already checked for if while in stmt
-  BasicIf* b = new BasicIf;
-  Expr* e = new Expr;
+  BasicIf* b = arena->make<BasicIf>();
+  Expr* e = arena->make<Expr>();
   expr(*e);
   b->expr = e;
   node.if_part = b;
@@ -314,15 +313,15 @@ void Parser::cond_stmt(IfStmt& node) {
 
 void Parser::condt(IfStmt& node) {
   if(curr_token.type() == ELSEIF) {
-    BasicIf* b = new BasicIf;
+    BasicIf* b = arena->make<BasicIf>();
     advance(); //already checked for ELSEIF
-    Expr* e = new Expr();
+    Expr* e = arena->make<Expr>();
     expr(*e);
     b->expr = e;
     eat(THEN, "expecting 'then' ");
     stmts(b->stmts);
-    condt(node);
     node.else_ifs.push_back(b);
+    condt(node);
   }else if(curr_token.type() == ELSE) {
     advance(); //already checked for ELSE
     stmts(node.body_stmts);
@@ -332,7 +331,7 @@ void Parser::condt(IfStmt& node) {
 
 void Parser::while_stmt(WhileStmt& node) {
   advance(); //already checked for WHILE
-  Expr* e = new Expr;
+  Expr* e = arena->make<Expr>();
   expr(*e);
   node.expr = e;
   eat(DO, "expecting 'do' ");
@@ -345,11 +344,11 @@ void Parser::for_stmt(ForStmt& node) {
   node.var_id = curr_token;
   eat(ID, "expecting ID ");
   eat(ASSIGN, "expecting '=' ");
-  Expr* e1 = new Expr;
+  Expr* e1 = arena->make<Expr>();
   expr(*e1);
   node.start = e1;
   eat(TO, "expecting 'to' ");
-  Expr* e2 = new Expr;
+  Expr* e2 = arena->make<Expr>();
   expr(*e2);
   node.end = e2;
   eat(DO, "expecting 'do' ");
@@ -364,13 +363,13 @@ void Parser::call_expr(CallExpr& node) {
   eat(RPAREN, "expecting ')' ");
 }
 
-void Parser::args(std::list<Expr*>& e) {
+void Parser::args(std::vector<Expr*>& e) {
   if(curr_token.type() != RPAREN) {
-    Expr* ex = new Expr;
+    Expr* ex = arena->make<Expr>();
     expr(*ex);
     e.push_back(ex);
     while(curr_token.type() == COMMA) {
-      Expr* exp = new Expr;
+      Expr* exp = arena->make<Expr>();
       advance();
       expr(*exp);
       e.push_back(exp);
@@ -381,7 +380,7 @@ void Parser::args(std::list<Expr*>& e) {
 
 void Parser::exit_stmt(ReturnStmt& node) {
   advance();
-  Expr* e = new Expr();
+  Expr* e = arena->make<Expr>();
   expr(*e);
   node.expr = e;
 }
@@ -392,24 +391,22 @@ void Parser::expr(Expr& e) {
     advance();
     expr(e);
   }else if(curr_token.type() == LPAREN) {
-    ComplexTerm* ct = new ComplexTerm;
-    Expr* ex = new Expr();
+    ComplexTerm* ct = arena->make<ComplexTerm>();
+    Expr* ex = arena->make<Expr>();
     advance();
     expr(*ex);
     ct->expr = ex;
     e.first = ct;
     eat(RPAREN, "expecting ')' ");
   }else {
-    SimpleTerm* s = new SimpleTerm();
+    SimpleTerm* s = arena->make<SimpleTerm>();
     rvalue(*s);
     e.first = s;
   }
   if(is_operator(curr_token.type())) {
     
-    Expr* ex = new Expr();
-    Token* tempOP = new Token();
-    *tempOP = curr_token;
-    e.op = tempOP;
+    Expr* ex = arena->make<Expr>();
+    e.op = arena->make<Token>(curr_token);
     advance();
     expr(*ex);
     e.rest = ex;
@@ -424,17 +421,17 @@ void Parser::rvalue(SimpleTerm& node) {
   TokenType t = curr_token.type();
   if(is_pval(t)) {
     if(_debug) std::cout << curr_token.lexeme() << std::endl;
-    SimpleRValue* s = new SimpleRValue;
+    SimpleRValue* s = arena->make<SimpleRValue>();
     s->value = curr_token;
     advance();
     node.rvalue = s;
   }else if(t == NIL) {
-    SimpleRValue* s = new SimpleRValue;
+    SimpleRValue* s = arena->make<SimpleRValue>();
     s->value = curr_token;
     advance();
     node.rvalue = s;
   }else if(t == NEW) {
-    NewRValue* n = new NewRValue;
+    NewRValue* n = arena->make<NewRValue>();
     advance();
     n->type_id = curr_token;
     eat(ID, "expecting ID ");
@@ -443,20 +440,20 @@ void Parser::rvalue(SimpleTerm& node) {
     Token temp = curr_token;
     advance();
     if(curr_token.type() == LPAREN) {
-      CallExpr* c = new CallExpr;
+      CallExpr* c = arena->make<CallExpr>();
       c->function_id = temp;
       call_expr(*c);
       node.rvalue = c;
     }else {
-      IDRValue* i = new IDRValue;
+      IDRValue* i = arena->make<IDRValue>();
       i->path.push_back(temp);
       idrval(*i);
       node.rvalue = i;
     }
   }else if(t == NEG) {
-    NegatedRValue* n = new NegatedRValue;
+    NegatedRValue* n = arena->make<NegatedRValue>();
     advance();
-    Expr* e= new Expr;
+    Expr* e= arena->make<Expr>();
     expr(*e);
     n->expr = e;
     node.rvalue = n;
@@ -12,6 +12,7 @@
 #define PRINTER_H
 
 #include <iostream>
+#include <list>
 #include "ast.h"
 #include <typeinfo>
 
@@ -156,13 +157,11 @@ void Printer::visit(VarDeclStmt& node) {
 void Printer::visit(AssignStmt& node) {
   if(_debug) std::cout << " VISIT ASSIGN " << std::endl;
   //print lhs
-  while(node.lvalue_list.size() > 1) {
-    out << node.lvalue_list.front().lexeme() << "->";
-    node.lvalue_list.pop_front(); //sets up for next visit
+  for(size_t i = 0; i + 1 < node.lvalue_list.size(); ++i) {
+    out << node.lvalue_list[i].lexeme() << "->";
   }
   //if required to not print extra dot at the end of list
-  out << node.lvalue_list.front().lexeme();
-  node.lvalue_list.pop_front(); //trying to reduce memory leaks
+  out << node.lvalue_list.back().lexeme();
 //print =
   out << " = ";
 //print rhs
@@ -342,14 +341,11 @@ void Printer::visit(NewRValue& node) {
 void Printer::visit(CallExpr& node) {
   if(_debug) std::cout << " VISIT CALL " << std::endl;
   out << node.function_id.lexeme() << "(";
-  while(node.arg_list.size() > 1) {
-    node.arg_list.front()->accept(*this);
-    out << ", ";
-    node.arg_list.pop_front();
-  }
-  if(node.arg_list.size() > 0) {
-    node.arg_list.front()->accept(*this);
-    node.arg_list.pop_front();
+  for(size_t i = 0; i < node.arg_list.size(); ++i) {
+    if(i > 0) {
+      out << ", ";
+    }
+    node.arg_list[i]->accept(*this);
   }
   out << ")";
 }
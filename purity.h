@@ -0,0 +1,238 @@
+//----------------------------------------------------------------------
+// NAME: Brennan Longstreth
+// FILE: purity.h
+// CONTRIBUTORS:
+// DATE: Fall 2026
+// DESC: Finds the functions whose result only depends on their
+//       argument values, so a call can be answered from earlier calls
+//       with the same arguments. A function is pure if its parameters
+//       and return type are primitive (int, double, bool, char, or
+//       string), it assigns no fields, creates no objects, doesn't
+//       print or read, and only calls pure functions.
+// NOTES: Runs after the resolver (calls must be linked). Recursive
+//        functions start out pure and are only marked impure if some
+//        function they (indirectly) call isn't.
+//----------------------------------------------------------------------
+
+#ifndef PURITY_H
+#define PURITY_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ast.h"
+
+
+class PurityChecker : public Visitor
+{
+public:
+
+  // top-level
+  void visit(Program& node);
+  void visit(FunDecl& node);
+  void visit(TypeDecl& node);
+  // statements
+  void visit(VarDeclStmt& node);
+  void visit(AssignStmt& node);
+  void visit(ReturnStmt& node);
+  void visit(IfStmt& node);
+  void visit(WhileStmt& node);
+  void visit(ForStmt& node);
+  // expressions
+  void visit(Expr& node);
+  void visit(SimpleTerm& node);
+  void visit(ComplexTerm& node);
+  // rvalues
+  void visit(SimpleRValue& node);
+  void visit(NewRValue& node);
+  void visit(CallExpr& node);
+  void visit(IDRValue& node);
+  void visit(NegatedRValue& node);
+
+private:
+
+  // set while visiting a function if it does anything impure itself
+  bool impure = false;
+
+  // the functions calling each function
+  std::unordered_map<FunDecl*,std::vector<FunDecl*>> callers;
+  FunDecl* curr_fun = nullptr;
+
+  // helpers
+  void visit_block(std::vector<Stmt*>& stmts);
+  static bool primitive(const Token& type);
+};
+
+
+bool PurityChecker::primitive(const Token& type)
+{
+  const std::string& name = type.lexeme();
+  return name == "int" or name == "double" or name == "bool" or
+    name == "char" or name == "string";
+}
+
+
+void PurityChecker::visit_block(std::vector<Stmt*>& stmts)
+{
+  for (Stmt* s : stmts)
+    s->accept(*this);
+}
+
+
+//----------------------------------------------------------------------
+// TOP-LEVEL
+//----------------------------------------------------------------------
+
+void PurityChecker::visit(Program& node)
+{
+  std::vector<FunDecl*> impure_funs;
+  for (Decl* d : node.decls)
+    if (FunDecl* f = dynamic_cast<FunDecl*>(d)) {
+      f->accept(*this);
+      if (!f->pure)
+        impure_funs.push_back(f);
+    }
+  // a function calling an impure one is impure
+  while (!impure_funs.empty()) {
+    FunDecl* f = impure_funs.back();
+    impure_funs.pop_back();
+    for (FunDecl* caller : callers[f])
+      if (caller->pure) {
+        caller->pure = false;
+        impure_funs.push_back(caller);
+      }
+  }
+}
+
+
+void PurityChecker::visit(FunDecl& node)
+{
+  impure = !primitive(node.return_type);
+  for (FunDecl::FunParam& p : node.params)
+    if (!primitive(p.type))
+      impure = true;
+  curr_fun = &node;
+  visit_block(node.stmts);
+  node.pure = !impure;
+}
+
+
+void PurityChecker::visit(TypeDecl&)
+{
+}
+
+
+//----------------------------------------------------------------------
+// STATEMENTS
+//----------------------------------------------------------------------
+
+void PurityChecker::visit(VarDeclStmt& node)
+{
+  node.expr->accept(*this);
+}
+
+
+void PurityChecker::visit(AssignStmt& node)
+{
+  if (node.lvalue_list.size() > 1)
+    impure = true;
+  node.expr->accept(*this);
+}
+
+
+void PurityChecker::visit(ReturnStmt& node)
+{
+  if (node.expr)
+    node.expr->accept(*this);
+}
+
+
+void PurityChecker::visit(IfStmt& node)
+{
+  node.if_part->expr->accept(*this);
+  visit_block(node.if_part->stmts);
+  for (BasicIf* b : node.else_ifs) {
+    b->expr->accept(*this);
+    visit_block(b->stmts);
+  }
+  visit_block(node.body_stmts);
+}
+
+
+void PurityChecker::visit(WhileStmt& node)
+{
+  node.expr->accept(*this);
+  visit_block(node.stmts);
+}
+
+
+void PurityChecker::visit(ForStmt& node)
+{
+  node.start->accept(*this);
+  node.end->accept(*this);
+  visit_block(node.stmts);
+}
+
+
+//----------------------------------------------------------------------
+// EXPRESSIONS
+//----------------------------------------------------------------------
+
+void PurityChecker::visit(Expr& node)
+{
+  node.first->accept(*this);
+  if (node.rest)
+    node.rest->accept(*this);
+}
+
+
+void PurityChecker::visit(SimpleTerm& node)
+{
+  node.rvalue->accept(*this);
+}
+
+
+void PurityChecker::visit(ComplexTerm& node)
+{
+  node.expr->accept(*this);
+}
+
+
+//----------------------------------------------------------------------
+// RVALUES
+//----------------------------------------------------------------------
+
+void PurityChecker::visit(SimpleRValue&)
+{
+}
+
+
+void PurityChecker::visit(NewRValue&)
+{
+  impure = true;
+}
+
+
+void PurityChecker::visit(CallExpr& node)
+{
+  if (node.built_in == PRINT_FUN or node.built_in == READ_FUN)
+    impure = true;
+  else if (node.built_in == USER_FUN)
+    callers[node.fun].push_back(curr_fun);
+  for (Expr* e : node.arg_list)
+    e->accept(*this);
+}
+
+
+void PurityChecker::visit(IDRValue&)
+{
+}
+
+
+void PurityChecker::visit(NegatedRValue& node)
+{
+  node.expr->accept(*this);
+}
+
+
+#endif
@@ -0,0 +1,357 @@
+//----------------------------------------------------------------------
+// NAME: Brennan Longstreth
+// FILE: resolver.h
+// CONTRIBUTORS:
+// DATE: Fall 2026
+// DESC: Gives every variable a slot in its function's frame so the
+//       interpreter can index the frame instead of looking names up.
+//       Blocks (function body, if/else-if/else body, while body, for
+//       loop variable together with its body) still scope the names,
+//       but not the storage: parameters take the first slots and each
+//       declaration gets the next free slot of the whole function, so
+//       a call allocates one frame and blocks allocate nothing at
+//       runtime. Slots of a finished block are reused by the blocks
+//       after it. Every call is also linked to the FunDecl it calls
+//       (or the built-in it names) and every new to its TypeDecl, so
+//       the interpreter never looks a function or type up by name.
+//       Calls in tail position (the whole expression of a return, or
+//       the last statement of a nil function) are marked so the
+//       interpreter can run them in the caller's frame.
+// NOTES: Runs after type checking. Functions start from an empty
+//        scope stack since MyPL has no global variables. A for loop
+//        variable is read-only in its body.
+//----------------------------------------------------------------------
+
+#ifndef RESOLVER_H
+#define RESOLVER_H
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "ast.h"
+#include "mypl_exception.h"
+
+
+class Resolver : public Visitor
+{
+public:
+
+  // top-level
+  void visit(Program& node);
+  void visit(FunDecl& node);
+  void visit(TypeDecl& node);
+  // statements
+  void visit(VarDeclStmt& node);
+  void visit(AssignStmt& node);
+  void visit(ReturnStmt& node);
+  void visit(IfStmt& node);
+  void visit(WhileStmt& node);
+  void visit(ForStmt& node);
+  // expressions
+  void visit(Expr& node);
+  void visit(SimpleTerm& node);
+  void visit(ComplexTerm& node);
+  // rvalues
+  void visit(SimpleRValue& node);
+  void visit(NewRValue& node);
+  void visit(CallExpr& node);
+  void visit(IDRValue& node);
+  void visit(NegatedRValue& node);
+
+private:
+
+  // name to slot mapping of a scope
+  typedef std::unordered_map<std::string,int> Scope;
+
+  // the enclosing scopes (innermost last)
+  std::vector<Scope> scopes;
+
+  // next free slot of the current function's frame, and the frame's
+  // size so far
+  int next_slot = 0;
+  int frame_size = 0;
+
+  // slots of the enclosing for loop variables
+  std::vector<int> loop_slots;
+
+  // the program's functions and types by name
+  std::unordered_map<std::string,FunDecl*> functions;
+  std::unordered_map<std::string,TypeDecl*> types;
+
+  // helpers
+  int declare(const Token& id);
+  int resolve(const Token& id);
+  void resolve_block(std::vector<Stmt*>& stmts);
+  void mark_tail_calls(std::vector<Stmt*>& stmts);
+  static CallExpr* user_call(Expr* expr);
+  void error(const std::string& msg, const Token& token);
+};
+
+
+void Resolver::error(const std::string& msg, const Token& token)
+{
+  throw MyPLException(SEMANTIC, msg, token.line(), token.column());
+}
+
+
+// add the name to the innermost scope and return its slot
+int Resolver::declare(const Token& id)
+{
+  Scope& scope = scopes.back();
+  if (scope.count(id.lexeme()))
+    error("'" + id.lexeme() + "' already declared in this scope", id);
+  int slot = next_slot++;
+  frame_size = std::max(frame_size, next_slot);
+  scope[id.lexeme()] = slot;
+  return slot;
+}
+
+
+// the slot of the innermost declaration of the name
+int Resolver::resolve(const Token& id)
+{
+  for (size_t i = scopes.size(); i > 0; --i) {
+    auto it = scopes[i-1].find(id.lexeme());
+    if (it != scopes[i-1].end())
+      return it->second;
+  }
+  error("undefined variable '" + id.lexeme() + "'", id);
+  return 0;
+}
+
+
+void Resolver::resolve_block(std::vector<Stmt*>& stmts)
+{
+  int mark = next_slot;
+  scopes.push_back(Scope());
+  for (Stmt* s : stmts)
+    s->accept(*this);
+  scopes.pop_back();
+  next_slot = mark;
+}
+
+
+// the call if the expression is nothing but a call to a function
+CallExpr* Resolver::user_call(Expr* expr)
+{
+  while (!expr->op and !expr->negated) {
+    if (ComplexTerm* ct = dynamic_cast<ComplexTerm*>(expr->first)) {
+      expr = ct->expr;
+      continue;
+    }
+    SimpleTerm* t = dynamic_cast<SimpleTerm*>(expr->first);
+    CallExpr* call = t ? dynamic_cast<CallExpr*>(t->rvalue) : nullptr;
+    if (call and call->built_in == USER_FUN)
+      return call;
+    break;
+  }
+  return nullptr;
+}
+
+
+// mark a call that ends the statements of a nil function (directly or
+// as the last statement of an if branch that ends them)
+void Resolver::mark_tail_calls(std::vector<Stmt*>& stmts)
+{
+  if (stmts.empty())
+    return;
+  Stmt* last = stmts.back();
+  if (CallExpr* call = dynamic_cast<CallExpr*>(last)) {
+    if (call->built_in == USER_FUN)
+      call->tail_call = true;
+  }
+  else if (IfStmt* s = dynamic_cast<IfStmt*>(last)) {
+    mark_tail_calls(s->if_part->stmts);
+    for (BasicIf* bi : s->else_ifs)
+      mark_tail_calls(bi->stmts);
+    mark_tail_calls(s->body_stmts);
+  }
+}
+
+
+//----------------------------------------------------------------------
+// TOP-LEVEL
+//----------------------------------------------------------------------
+
+void Resolver::visit(Program& node)
+{
+  // declarations can be used before they appear
+  for (Decl* d : node.decls) {
+    if (FunDecl* f = dynamic_cast<FunDecl*>(d))
+      functions[f->id.lexeme()] = f;
+    else if (TypeDecl* t = dynamic_cast<TypeDecl*>(d))
+      types[t->id.lexeme()] = t;
+  }
+  for (Decl* d : node.decls)
+    d->accept(*this);
+}
+
+
+void Resolver::visit(FunDecl& node)
+{
+  // parameters and body statements share the function's scope
+  next_slot = 0;
+  frame_size = 0;
+  scopes.push_back(Scope());
+  for (FunDecl::FunParam& p : node.params)
+    declare(p.id);
+  for (Stmt* s : node.stmts)
+    s->accept(*this);
+  scopes.pop_back();
+  node.frame_size = frame_size;
+  if (node.return_type.type() == NIL)
+    mark_tail_calls(node.stmts);
+}
+
+
+void Resolver::visit(TypeDecl& node)
+{
+  // field initializers are evaluated outside of any scope
+  std::vector<Scope> saved;
+  saved.swap(scopes);
+  for (VarDeclStmt* v : node.vdecls)
+    v->expr->accept(*this);
+  scopes.swap(saved);
+}
+
+
+//----------------------------------------------------------------------
+// STATEMENTS
+//----------------------------------------------------------------------
+
+void Resolver::visit(VarDeclStmt& node)
+{
+  // the initializer cannot see the variable being declared
+  node.expr->accept(*this);
+  node.slot = declare(node.id);
+}
+
+
+void Resolver::visit(AssignStmt& node)
+{
+  node.expr->accept(*this);
+  const Token& id = node.lvalue_list.front();
+  node.slot = resolve(id);
+  if (node.lvalue_list.size() == 1)
+    for (int slot : loop_slots)
+      if (slot == node.slot)
+        error("cannot assign to loop variable '" + id.lexeme() + "'", id);
+}
+
+
+void Resolver::visit(ReturnStmt& node)
+{
+  node.expr->accept(*this);
+  if (CallExpr* call = user_call(node.expr))
+    call->tail_call = true;
+}
+
+
+void Resolver::visit(IfStmt& node)
+{
+  node.if_part->expr->accept(*this);
+  resolve_block(node.if_part->stmts);
+  for (BasicIf* bi : node.else_ifs) {
+    bi->expr->accept(*this);
+    resolve_block(bi->stmts);
+  }
+  resolve_block(node.body_stmts);
+}
+
+
+void Resolver::visit(WhileStmt& node)
+{
+  node.expr->accept(*this);
+  resolve_block(node.stmts);
+}
+
+
+void Resolver::visit(ForStmt& node)
+{
+  // the loop variable and the body's variables share one scope
+  node.start->accept(*this);
+  node.end->accept(*this);
+  int mark = next_slot;
+  scopes.push_back(Scope());
+  node.slot = declare(node.var_id);
+  loop_slots.push_back(node.slot);
+  for (Stmt* s : node.stmts)
+    s->accept(*this);
+  loop_slots.pop_back();
+  scopes.pop_back();
+  next_slot = mark;
+}
+
+
+//----------------------------------------------------------------------
+// EXPRESSIONS
+//----------------------------------------------------------------------
+
+void Resolver::visit(Expr& node)
+{
+  node.first->accept(*this);
+  if (node.rest)
+    node.rest->accept(*this);
+}
+
+
+void Resolver::visit(SimpleTerm& node)
+{
+  node.rvalue->accept(*this);
+}
+
+
+void Resolver::visit(ComplexTerm& node)
+{
+  node.expr->accept(*this);
+}
+
+
+//----------------------------------------------------------------------
+// RVALUES
+//----------------------------------------------------------------------
+
+void Resolver::visit(SimpleRValue&)
+{
+}
+
+
+void Resolver::visit(NewRValue& node)
+{
+  auto it = types.find(node.type_id.lexeme());
+  if (it == types.end())
+    error("type '" + node.type_id.lexeme() + "' not defined", node.type_id);
+  node.type = it->second;
+}
+
+
+void Resolver::visit(CallExpr& node)
+{
+  // built-ins take precedence over functions of the same name
+  const std::string& name = node.function_id.lexeme();
+  node.built_in = built_in_named(name);
+  if (node.built_in == USER_FUN) {
+    auto f = functions.find(name);
+    if (f == functions.end())
+      error("function '" + name + "' not defined", node.function_id);
+    node.fun = f->second;
+  }
+  for (Expr* e : node.arg_list)
+    e->accept(*this);
+}
+
+
+void Resolver::visit(IDRValue& node)
+{
+  node.slot = resolve(node.path.front());
+}
+
+
+void Resolver::visit(NegatedRValue& node)
+{
+  node.expr->accept(*this);
+}
+
+
+#endif
@@ -0,0 +1,96 @@
+//----------------------------------------------------------------------
+// NAME: Brennan Longstreth
+// FILE: source_file.h
+// CONTRIBUTORS:
+// DATE: Fall 2026
+// DESC: Read-only memory mapping of a MyPL source file, so the lexer
+//       can scan the file's bytes in place without copying them.
+// NOTES: The mapping (and every pointer into it) is valid until the
+//        SourceFile is destroyed.
+//----------------------------------------------------------------------
+
+#ifndef SOURCE_FILE_H
+#define SOURCE_FILE_H
+
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+class SourceFile
+{
+public:
+
+  // map the given file (check is_open() for success)
+  SourceFile(const std::string& path);
+  SourceFile(const SourceFile&) = delete;
+  SourceFile& operator=(const SourceFile&) = delete;
+
+  // unmap the file
+  ~SourceFile();
+
+  // true if the file was opened and mapped
+  bool is_open() const;
+
+  // the file's contents
+  const char* begin() const;
+  const char* end() const;
+
+private:
+  const char* data = nullptr;
+  size_t size = 0;
+  bool opened = false;
+};
+
+
+SourceFile::SourceFile(const std::string& path)
+{
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return;
+  struct stat info;
+  if (fstat(fd, &info) == 0) {
+    size = info.st_size;
+    // an empty file can't be mapped, but is still a valid source
+    if (size == 0)
+      opened = true;
+    else {
+      void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (p != MAP_FAILED) {
+        data = static_cast<const char*>(p);
+        opened = true;
+      }
+    }
+  }
+  close(fd);
+}
+
+
+SourceFile::~SourceFile()
+{
+  if (data)
+    munmap(const_cast<char*>(data), size);
+}
+
+
+bool SourceFile::is_open() const
+{
+  return opened;
+}
+
+
+const char* SourceFile::begin() const
+{
+  return data;
+}
+
+
+const char* SourceFile::end() const
+{
+  return data + size;
+}
+
+
+#endif
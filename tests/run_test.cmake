@@ -0,0 +1,18 @@
+######################################################
+# Name: Brennan Longstreth
+# File: run_test.cmake
+# Contributors:
+# Descritpion: Runs mypl on one test program and compares its output
+#              (stdout and stderr together) to the expected output
+# Notes: called by ctest with MYPL, SOURCE, EXPECTED and FLAGS set
+# Date Edited: Fall 2026
+######################################################
+
+separate_arguments(FLAGS)
+execute_process(COMMAND ${MYPL} ${FLAGS} ${SOURCE}
+                OUTPUT_VARIABLE output ERROR_VARIABLE output)
+file(READ ${EXPECTED} expected)
+if(NOT output STREQUAL expected)
+  message(FATAL_ERROR "output of ${SOURCE} differs from ${EXPECTED}:\n"
+                      "${output}")
+endif()
@@ -4,14 +4,20 @@
 // CONTRIBUTORS: Shawn Bowers
 // DATE: Spring 2021
 // DESC: Token representation for MyPL.
-// NOTES: 
+// NOTES: Lexemes are interned: each distinct lexeme is stored once in
+//        the Symbols table and a Token only holds its id, so tokens
+//        are small and trivially copyable. Interned strings live for
+//        the rest of the process.
 //----------------------------------------------------------------------
 
 #ifndef TOKEN_H
 #define TOKEN_H
 
+#include <cstdint>
+#include <cstring>
+#include <deque>
 #include <string>
-#include <map>
+#include <vector>
 
 
 // MyPL allowable token types
@@ -36,6 +42,34 @@ enum TokenType {
 };
 
 
+// Interning table giving every distinct lexeme one id
+class Symbols
+{
+public:
+
+  // return the id of the given characters (adding them if new)
+  static uint32_t intern(const char* text, size_t length);
+
+  // return the string with the given id
+  static const std::string& name(uint32_t id);
+
+private:
+
+  Symbols();
+
+  // the interned strings, indexed by id (a deque so references to
+  // them stay valid as more are added)
+  std::deque<std::string> names;
+
+  // open-addressing hash table of id + 1 (0 marks an empty slot)
+  std::vector<uint32_t> slots;
+
+  static Symbols& pool();
+  static size_t hash(const char* text, size_t length);
+  void grow();
+};
+
+
 class Token
 {
 public:
@@ -46,6 +80,10 @@ public:
   // constructor
   Token(TokenType type, const std::string& lexeme, int line, int column);
 
+  // constructor from characters in a source buffer
+  Token(TokenType type, const char* lexeme, size_t length, int line,
+        int column);
+
   // return the type of the token
   TokenType type() const;
 
@@ -53,7 +91,11 @@ public:
   void setType(std::string newType);
 
   // return the token string value
-  std::string lexeme() const;
+  const std::string& lexeme() const;
+
+  // return the interned id of the lexeme (equal ids mean equal
+  // lexemes)
+  uint32_t symbol() const;
 
   // return the line location of lexeme
   int line() const;
@@ -66,67 +108,120 @@ public:
   
 private:
 
-  // the type of the token 
-  TokenType token_type;
-
-  // the token's value in the program
-  std::string token_lexeme;
+  // the token's value in the program (an interned id)
+  uint32_t token_symbol;
 
   // the line location of the lexeme (starts at 1)
-  int token_line;
-
-  // the column location of the start of the lexeme (starts at 1)
-  int token_column;
+  uint32_t token_line;
 
-  // token type to string representation (for printing)
-  std::map<TokenType,std::string> token_type_map =
-    { // basic symbols 6
-      {ASSIGN,"ASSIGN"},{COMMA,"COMMA"},{DOT,"DOT"},{LPAREN,"LPAREN"},
-      {RPAREN,"RPAREN"},{COLON,"COLON"},
-      // math operators 7
-      {PLUS, "PLUS"}, {MINUS, "MINUS"}, {MULTIPLY, "MULTIPLY"},
-      {DIVIDE, "DIVIDE"}, {MODULO, "MODULO"}, {NEG, "NEG"},
-      {STRING_VAL, "STRING_VAL"},
-      // logical operators 3
-      {AND, "AND"}, {OR, "OR"}, {NOT, "NOT"},
-      // comparators 6
-      {EQUAL, "EQUAL"}, {GREATER, "GREATER"},
-      {GREATER_EQUAL, "GREATER_EQUAL"}, {LESS, "LESS"},
-      {LESS_EQUAL, "LESS_EQUAL"}, {NOT_EQUAL, "NOT_EQUAL"},
-      // reserved words 14
-      {TYPE,"TYPE"},{WHILE,"WHILE"},{FOR,"FOR"},{TO,"TO"},{DO,"DO"},{IF,"IF"},
-      {THEN,"THEN"},{ELSEIF,"ELSEIF"},{ELSE,"ELSE"},{END,"END"},
-      {FUN,"FUN"},{VAR,"VAR"},{RETURN,"RETURN"},{NEW,"NEW"},
-      // primitive types 5
-      {BOOL_TYPE, "BOOL_TYPE"}, {INT_TYPE, "INT_TYPE"},
-      {DOUBLE_TYPE, "DOUBLE_TYPE"}, {CHAR_TYPE, "CHAR_TYPE"},
-      {STRING_TYPE, "STRING_TYPE"}, 
-      // values 7
-      {BOOL_VAL, "BOOL_VAL"}, {INT_VAL, "INT_VAL"},
-      {DOUBLE_VAL, "DOUBLE_VAL"}, {STRING_VAL, "STRING_VAL"},
-      {CHAR_VAL, "CHAR_VAL"}, {ID, "ID"}, {NIL, "NIL"},
-      // eos 1
-      {EOS, "EOS"}
-    };
+  // the type of the token, packed with the column location of the
+  // start of the lexeme (starts at 1)
+  uint32_t token_type : 8;
+  uint32_t token_column : 24;
 };
 
 
+//----------------------------------------------------------------------
+// Symbols Member Functions
+//----------------------------------------------------------------------
+
+Symbols::Symbols()
+{
+  // id 0 is the empty lexeme (of default tokens)
+  names.push_back("");
+  slots.resize(1024);
+  slots[hash("", 0) & (slots.size() - 1)] = 1;
+}
+
+
+Symbols& Symbols::pool()
+{
+  static Symbols symbols;
+  return symbols;
+}
+
+
+// FNV-1a
+size_t Symbols::hash(const char* text, size_t length)
+{
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < length; ++i)
+    h = (h ^ (unsigned char)text[i]) * 16777619u;
+  return h;
+}
+
+
+void Symbols::grow()
+{
+  std::vector<uint32_t> old(2 * slots.size());
+  old.swap(slots);
+  size_t mask = slots.size() - 1;
+  for (uint32_t id : old) {
+    if (!id)
+      continue;
+    const std::string& s = names[id - 1];
+    size_t i = hash(s.data(), s.size()) & mask;
+    while (slots[i])
+      i = (i + 1) & mask;
+    slots[i] = id;
+  }
+}
+
+
+uint32_t Symbols::intern(const char* text, size_t length)
+{
+  Symbols& p = pool();
+  // keep the table at most half full
+  if (2 * (p.names.size() + 1) > p.slots.size())
+    p.grow();
+  size_t mask = p.slots.size() - 1;
+  size_t i = hash(text, length) & mask;
+  while (p.slots[i]) {
+    const std::string& s = p.names[p.slots[i] - 1];
+    if (s.size() == length and std::memcmp(s.data(), text, length) == 0)
+      return p.slots[i] - 1;
+    i = (i + 1) & mask;
+  }
+  p.names.emplace_back(text, length);
+  p.slots[i] = p.names.size();
+  return p.names.size() - 1;
+}
+
+
+const std::string& Symbols::name(uint32_t id)
+{
+  return pool().names[id];
+}
+
+
+//----------------------------------------------------------------------
+// Token Member Functions
+//----------------------------------------------------------------------
+
 Token::Token()
-  : token_type(EOS), token_lexeme(""), token_line(0), token_column(0)
+  : token_symbol(0), token_line(0), token_type(EOS), token_column(0)
 {
 }
 
 
 Token::Token(TokenType type, const std::string& lexeme, int line, int column)
-  : token_type(type), token_lexeme(lexeme), token_line(line),
-    token_column(column)
+  : token_symbol(Symbols::intern(lexeme.data(), lexeme.size())),
+    token_line(line), token_type(type), token_column(column)
+{
+}
+
+
+Token::Token(TokenType type, const char* lexeme, size_t length, int line,
+             int column)
+  : token_symbol(Symbols::intern(lexeme, length)), token_line(line),
+    token_type(type), token_column(column)
 {
 }
 
 
 TokenType Token::type() const
 {
-  return token_type;
+  return (TokenType)token_type;
 }
 
 void Token::setType(std::string newType) {
@@ -144,9 +239,15 @@ void Token::setType(std::string newType) {
   }
 }
 
-std::string Token::lexeme() const
+const std::string& Token::lexeme() const
 {
-  return token_lexeme;
+  return Symbols::name(token_symbol);
+}
+
+
+uint32_t Token::symbol() const
+{
+  return token_symbol;
 }
 
 
@@ -163,7 +264,28 @@ int Token::column() const
 
 std::string Token::to_string() const
 {
-  return token_type_map.find(token_type)->second +
+  // token type to string representation (for printing)
+  static const char* const type_names[] = {
+    // basic symbols
+    "ASSIGN", "COMMA", "DOT", "LPAREN", "RPAREN", "COLON",
+    // math operators
+    "PLUS", "MINUS", "MULTIPLY", "DIVIDE", "MODULO", "NEG",
+    // logical operators
+    "AND", "OR", "NOT",
+    // comparators
+    "EQUAL", "GREATER", "GREATER_EQUAL", "LESS", "LESS_EQUAL", "NOT_EQUAL",
+    // reserved words
+    "TYPE", "WHILE", "FOR", "TO", "DO", "IF", "THEN", "ELSEIF", "ELSE",
+    "END", "FUN", "VAR", "RETURN", "NEW",
+    // primitive types
+    "BOOL_TYPE", "INT_TYPE", "DOUBLE_TYPE", "CHAR_TYPE", "STRING_TYPE",
+    // values
+    "BOOL_VAL", "INT_VAL", "DOUBLE_VAL", "STRING_VAL", "CHAR_VAL", "ID",
+    "NIL",
+    // end-of-stream
+    "EOS"
+  };
+  return std::string(type_names[token_type]) +
     " '" + lexeme() + "' " +
     std::to_string(line()) + ":" + std::to_string(column());
 }
@@ -14,6 +14,7 @@
 
 #include <iterator>
 #include <iostream>
+#include <unordered_map>
 #include "ast.h"
 #include "symbol_table.h"
 
@@ -52,6 +53,15 @@ private:
   // the previously inferred type
   std::string curr_type;
 
+  // the program's node storage (for inferred type tokens)
+  Arena* arena = nullptr;
+
+  // user-defined types by name (for field offsets)
+  std::unordered_map<std::string,TypeDecl*> type_decls;
+
+  // offset of the field within the given type's declaration
+  int field_offset(const std::string& type, const Token& field);
+
   // helper to add built in functions
   void initialize_built_in_types();
 
@@ -64,6 +74,15 @@ private:
 
   //takes type int and puts it to a string
   std::string typeToString(int t);
+
+  //decodes an operator token
+  BinOp decode_op(TokenType t);
+
+  //runtime representation of a type name
+  DataObject::DataType static_type(const std::string& type);
+
+  //decodes a literal token into its value
+  void decode_literal(SimpleRValue& node);
 };
 
 
@@ -79,6 +98,19 @@ void TypeChecker::error(const std::string& msg)
 }
 
 
+int TypeChecker::field_offset(const std::string& type, const Token& field)
+{
+  int offset = 0;
+  for (VarDeclStmt* v : type_decls[type]->vdecls) {
+    if (v->id.lexeme() == field.lexeme())
+      return offset;
+    ++offset;
+  }
+  error("'" + field.lexeme() + "' is not a field of type " + type, field);
+  return -1;
+}
+
+
 void TypeChecker::initialize_built_in_types()
 {
   // print function
@@ -112,6 +144,7 @@ void TypeChecker::initialize_built_in_types()
 
 void TypeChecker::visit(Program& node)
 {
+  arena = &node.arena;
   // push the global environment
   sym_table.push_environment();
   // add built-in functions
@@ -185,6 +218,7 @@ void TypeChecker::visit(TypeDecl& node) {
     error("Type already declared", node.id);
   }
   sym_table.add_name(node.id.lexeme());
+  type_decls[node.id.lexeme()] = &node;
   StringMap s;
   sym_table.push_environment();
   for(VarDeclStmt* v : node.vdecls) {
@@ -225,7 +259,7 @@ void TypeChecker::visit(VarDeclStmt& node) {
 
     //set tree data to match type inference
     if(!node.type) {
-      node.type = new Token(NIL,curr_type,0,0);
+      node.type = arena->make<Token>(NIL,curr_type,0,0);
       node.type->setType(curr_type);
     }
   }else {
@@ -256,12 +290,15 @@ void TypeChecker::visit(AssignStmt& node) {
     }
   }
   //std::cout << temp << std::endl;
+  node.offsets.clear();
   while (t != --(node.lvalue_list.end())) {
     if(sym_table.has_map_info(temp)) {
       //get map info
       std::map<std::string,std::string> curr_map;
       sym_table.get_map_info(temp,curr_map);
 
+      //record where the field lives in the object
+      node.offsets.push_back(field_offset(temp, *std::next(t)));
       //get value from map at ++t->lexeme()
       temp = curr_map[(++t)->lexeme()];
       //std::cout << temp << std::endl;
@@ -379,7 +416,13 @@ void TypeChecker::visit(Expr& node) {
   if(node.op) {
     if(!is_legal_op(node.op->lexeme(),lhs,curr_type)) {
       error("Illegal operator \'" + node.op->lexeme() + "\' for " + lhs + " and " + curr_type, *node.op);
-    }else 
+    }
+    //record the operator and operand types for the interpreter
+    node.bin_op = decode_op(node.op->type());
+    node.lhs_type = static_type(lhs);
+    node.rhs_type = static_type(curr_type);
+    node.kernel = select_kernel(node.bin_op, node.lhs_type, node.rhs_type);
+    
     //checking operator rules
     if(lhs == "string" && curr_type == "char") {
       curr_type = "string";
@@ -398,6 +441,7 @@ void TypeChecker::visit(Expr& node) {
   if(node.negated && (curr_type != "bool" && curr_type != "int" && curr_type != "double")) {
     error("Expecting bool or int or double expression, recieved: " + curr_type, node.first_token());
   }
+  node.type = static_type(curr_type);
 
 
 
@@ -468,6 +512,7 @@ void TypeChecker::visit(ComplexTerm& node) {
 void TypeChecker::visit(SimpleRValue& node) {
   //std::cout << "SimpleRValue: " << node.value.lexeme() << " " << node.value.type() << std::endl;
   curr_type = typeToString(node.value.type()); 
+  decode_literal(node);
 }
 
 void TypeChecker::visit(NewRValue& node) {
@@ -512,12 +557,15 @@ void TypeChecker::visit(IDRValue& node) {
     sym_table.get_str_info(t->lexeme(),temp);
   }
   //std::cout << temp << std::endl;
+  node.offsets.clear();
   while (t != --(node.path.end())) {
     if(sym_table.has_map_info(temp)) {
       //get map info
       std::map<std::string,std::string> curr_map;
       sym_table.get_map_info(temp,curr_map);
 
+      //record where the field lives in the object
+      node.offsets.push_back(field_offset(temp, *std::next(t)));
       //get value from map at ++t->lexeme()
       temp = curr_map[(++t)->lexeme()];
       //std::cout << temp << std::endl;
@@ -532,6 +580,82 @@ void TypeChecker::visit(NegatedRValue& node) {
   std::cout << "Negative" << std::endl;
 }
 
+BinOp TypeChecker::decode_op(TokenType t) {
+  switch(t) {
+    case PLUS: return BIN_ADD;
+    case MINUS: return BIN_SUB;
+    case MULTIPLY: return BIN_MUL;
+    case DIVIDE: return BIN_DIV;
+    case MODULO: return BIN_MOD;
+    case AND: return BIN_AND;
+    case OR: return BIN_OR;
+    case EQUAL: return BIN_EQ;
+    case NOT_EQUAL: return BIN_NE;
+    case LESS: return BIN_LT;
+    case LESS_EQUAL: return BIN_LE;
+    case GREATER: return BIN_GT;
+    case GREATER_EQUAL: return BIN_GE;
+    default: return BIN_NONE;
+  }
+}
+
+DataObject::DataType TypeChecker::static_type(const std::string& type) {
+  if(type == "int") return DataObject::INTEGER;
+  if(type == "double") return DataObject::DOUBLE;
+  if(type == "string") return DataObject::STRING;
+  if(type == "char") return DataObject::CHAR;
+  if(type == "bool") return DataObject::BOOL;
+  if(type == "nil" || type == "") return DataObject::NIL;
+  //user-defined types are objects
+  return DataObject::OID;
+}
+
+void TypeChecker::decode_literal(SimpleRValue& node) {
+  const std::string& lexeme = node.value.lexeme();
+  switch(node.value.type()) {
+    case CHAR_VAL:
+      node.literal.set(lexeme.at(0));
+      break;
+    case STRING_VAL: {
+      //expand \n and \t escapes once here instead of on every print
+      std::string s;
+      s.reserve(lexeme.size());
+      for(size_t i = 0; i < lexeme.size(); ++i) {
+        if(lexeme[i] == '\\' && i + 1 < lexeme.size() && lexeme[i+1] == 'n') {
+          s += '\n';
+          ++i;
+        }else if(lexeme[i] == '\\' && i + 1 < lexeme.size() && lexeme[i+1] == 't') {
+          s += '\t';
+          ++i;
+        }else {
+          s += lexeme[i];
+        }
+      }
+      node.literal.set(s);
+      break;
+    }
+    case INT_VAL:
+      try {
+        node.literal.set(std::stoi(lexeme));
+      }catch(const std::out_of_range& e) {
+        error("int out of range", node.value);
+      }
+      break;
+    case DOUBLE_VAL:
+      try {
+        node.literal.set(std::stod(lexeme));
+      }catch(const std::out_of_range& e) {
+        error("double out of range", node.value);
+      }
+      break;
+    case BOOL_VAL:
+      node.literal.set(lexeme == "true");
+      break;
+    default:
+      node.literal.set_nil();
+  }
+}
+
 std::string TypeChecker::typeToString(int t) {
   //std::cout << "called type to string" << std::endl;
   switch(t) {
@@ -0,0 +1,360 @@
+//----------------------------------------------------------------------
+// NAME: Brennan Longstreth
+// FILE: vm.h
+// CONTRIBUTORS:
+// DATE: Fall 2026
+// DESC: Virtual machine that runs a compiled BytecodeProgram. All
+//       frames share one register stack and calls push a frame
+//       record instead of recursing in C++, so deep MyPL recursion
+//       only grows the register stack.
+// NOTES: Objects of user-defined types are stored as a fixed array of
+//        field values indexed by the object id.
+//----------------------------------------------------------------------
+
+#ifndef VM_H
+#define VM_H
+
+#include <climits>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "bytecode.h"
+#include "data_object.h"
+#include "kernels.h"
+#include "mypl_exception.h"
+
+
+class VM
+{
+public:
+
+  // create a vm for the given (compiled) program
+  VM(const BytecodeProgram& program);
+
+  // run the program's main function
+  void run();
+
+  // return code from calling main
+  int return_code() const;
+
+private:
+
+  // saved state of a calling function
+  struct Frame
+  {
+    const BytecodeFunction* fun;
+    size_t pc;
+    size_t base;
+    int ret_reg;
+  };
+
+  const BytecodeProgram& prog;
+
+  // the register stack (each frame is a window into it)
+  std::vector<DataObject> registers;
+
+  // the call stack (not including the running function)
+  std::vector<Frame> frames;
+
+  // object fields, indexed by oid (oid 0 is never used)
+  std::vector<std::vector<DataObject>> objects;
+
+  // the program return code
+  int ret_code = 0;
+
+  // helpers
+  std::vector<DataObject>& object(const DataObject& ref,
+                                  const BytecodeFunction* fun, size_t pc);
+  void error(const std::string& msg, const BytecodeFunction* fun, size_t pc);
+};
+
+
+VM::VM(const BytecodeProgram& program)
+  : prog(program)
+{
+  objects.push_back(std::vector<DataObject>());
+}
+
+
+int VM::return_code() const
+{
+  return ret_code;
+}
+
+
+void VM::error(const std::string& msg, const BytecodeFunction* fun, size_t pc)
+{
+  std::pair<int,int> pos = fun->positions[pc];
+  throw MyPLException(RUNTIME, msg, pos.first, pos.second);
+}
+
+
+std::vector<DataObject>& VM::object(const DataObject& ref,
+                                    const BytecodeFunction* fun, size_t pc)
+{
+  size_t oid;
+  if (!ref.value(oid))
+    error("nil object in path expression", fun, pc);
+  return objects[oid];
+}
+
+
+//----------------------------------------------------------------------
+// DISPATCH LOOP
+//----------------------------------------------------------------------
+
+// fetch both operands of a binary instruction, or report a nil operand
+#define OPERANDS(T)                                                     \
+  T l, r;                                                               \
+  if (!R[i.b].value(l) or !R[i.c].value(r))                             \
+    error("Expression term is nil", fun, pc - 1)
+
+void VM::run()
+{
+  const BytecodeFunction* fun = &prog.functions[prog.main_index];
+  const DataObject* K = prog.constants.data();
+  size_t base = 0;
+  size_t pc = 0;
+  registers.resize(fun->register_count + 1);
+  DataObject* R = registers.data();
+
+  for (;;) {
+    const Instr& i = fun->code[pc++];
+    switch (i.op) {
+
+      case OP_LOADK: R[i.a] = K[i.b]; break;
+      case OP_LOADNIL: R[i.a].set_nil(); break;
+      case OP_MOVE: R[i.a] = R[i.b]; break;
+
+      case OP_ADD_I: {OPERANDS(int); R[i.a].set(l + r); break;}
+      case OP_SUB_I: {OPERANDS(int); R[i.a].set(l - r); break;}
+      case OP_MUL_I: {OPERANDS(int); R[i.a].set(l * r); break;}
+      case OP_DIV_I: {
+        OPERANDS(int);
+        if (r == 0)
+          error("division by zero", fun, pc - 1);
+        R[i.a].set(l / r);
+        break;
+      }
+      case OP_MOD_I: {
+        OPERANDS(int);
+        if (r == 0)
+          error("division by zero", fun, pc - 1);
+        R[i.a].set(l % r);
+        break;
+      }
+      case OP_ADD_D: {OPERANDS(double); R[i.a].set(l + r); break;}
+      case OP_SUB_D: {OPERANDS(double); R[i.a].set(l - r); break;}
+      case OP_MUL_D: {OPERANDS(double); R[i.a].set(l * r); break;}
+      case OP_DIV_D: {OPERANDS(double); R[i.a].set(l / r); break;}
+
+      case OP_CONCAT: {
+        std::string l, r;
+        char c;
+        if (R[i.b].value(c))
+          l = c;
+        else if (!R[i.b].value(l))
+          error("Expression term is nil", fun, pc - 1);
+        if (R[i.c].value(c))
+          r = c;
+        else if (!R[i.c].value(r))
+          error("Expression term is nil", fun, pc - 1);
+        R[i.a].set(l + r);
+        break;
+      }
+
+      case OP_LT_I: {OPERANDS(int); R[i.a].set(l < r); break;}
+      case OP_LE_I: {OPERANDS(int); R[i.a].set(l <= r); break;}
+      case OP_GT_I: {OPERANDS(int); R[i.a].set(l > r); break;}
+      case OP_GE_I: {OPERANDS(int); R[i.a].set(l >= r); break;}
+      case OP_LT_D: {OPERANDS(double); R[i.a].set(l < r); break;}
+      case OP_LE_D: {OPERANDS(double); R[i.a].set(l <= r); break;}
+      case OP_GT_D: {OPERANDS(double); R[i.a].set(l > r); break;}
+      case OP_GE_D: {OPERANDS(double); R[i.a].set(l >= r); break;}
+      case OP_LT_S: {OPERANDS(std::string); R[i.a].set(l < r); break;}
+      case OP_LE_S: {OPERANDS(std::string); R[i.a].set(l <= r); break;}
+      case OP_GT_S: {OPERANDS(std::string); R[i.a].set(l > r); break;}
+      case OP_GE_S: {OPERANDS(std::string); R[i.a].set(l >= r); break;}
+      case OP_LT_C: {OPERANDS(char); R[i.a].set(l < r); break;}
+      case OP_LE_C: {OPERANDS(char); R[i.a].set(l <= r); break;}
+      case OP_GT_C: {OPERANDS(char); R[i.a].set(l > r); break;}
+      case OP_GE_C: {OPERANDS(char); R[i.a].set(l >= r); break;}
+
+      case OP_EQ:
+      case OP_NE: {
+        bool eq = values_equal(R[i.b], R[i.c]);
+        R[i.a].set(i.op == OP_EQ ? eq : !eq);
+        break;
+      }
+
+      case OP_AND: {OPERANDS(bool); R[i.a].set(l and r); break;}
+      case OP_OR: {OPERANDS(bool); R[i.a].set(l or r); break;}
+      case OP_NOT: {
+        bool v;
+        if (!R[i.b].value(v))
+          error("Expression term is nil", fun, pc - 1);
+        R[i.a].set(!v);
+        break;
+      }
+      case OP_NEG_I: {
+        int v;
+        if (!R[i.b].value(v))
+          error("Expression term is nil", fun, pc - 1);
+        R[i.a].set(-v);
+        break;
+      }
+      case OP_NEG_D: {
+        double v;
+        if (!R[i.b].value(v))
+          error("Expression term is nil", fun, pc - 1);
+        R[i.a].set(-v);
+        break;
+      }
+
+      case OP_JMP: pc = i.a; break;
+      case OP_JMPF: {
+        bool v = false;
+        R[i.a].value(v);
+        if (!v)
+          pc = i.b;
+        break;
+      }
+      case OP_JMPAND:
+      case OP_JMPOR: {
+        bool v;
+        if (!R[i.b].value(v))
+          error("Expression term is nil", fun, pc - 1);
+        // the result is only written when the rest is skipped, since
+        // R[a] may be a variable the rest still reads
+        if (v == (i.op == OP_JMPOR)) {
+          R[i.a].set(v);
+          pc = i.c;
+        }
+        break;
+      }
+      case OP_FORBOUND:
+        if (R[i.a].is_nil())
+          error(i.b ? "nil for loop end" : "nil for loop start", fun, pc - 1);
+        break;
+      case OP_FORTEST: {
+        int var, end;
+        R[i.a].value(var);
+        R[i.b].value(end);
+        if (var > end)
+          pc = i.c;
+        break;
+      }
+      case OP_FORSTEP: {
+        // the loop ends after INT_MAX without overflowing
+        int v;
+        R[i.a].value(v);
+        if (v < INT_MAX) {
+          R[i.a].set(v + 1);
+          pc = i.b;
+        }
+        break;
+      }
+
+      case OP_CALL: {
+        const BytecodeFunction* callee = &prog.functions[i.a];
+        frames.push_back(Frame{fun, pc, base, i.c});
+        base += i.b;
+        size_t needed = base + callee->register_count + 1;
+        if (registers.size() < needed)
+          registers.resize(std::max(needed, 2 * registers.size()));
+        fun = callee;
+        pc = 0;
+        R = registers.data() + base;
+        break;
+      }
+      case OP_RET:
+      case OP_RETNIL: {
+        DataObject val;
+        if (i.op == OP_RET)
+          val = R[i.a];
+        if (frames.empty())
+          return;
+        Frame& f = frames.back();
+        fun = f.fun;
+        pc = f.pc;
+        base = f.base;
+        R = registers.data() + base;
+        R[f.ret_reg] = val;
+        frames.pop_back();
+        break;
+      }
+
+      case OP_NEW: {
+        size_t oid = objects.size();
+        objects.push_back(std::vector<DataObject>(
+          prog.types[i.b].fields.size()));
+        R[i.a].set(oid);
+        break;
+      }
+      case OP_GETF: R[i.a] = object(R[i.b], fun, pc - 1)[i.c]; break;
+      case OP_SETF: object(R[i.a], fun, pc - 1)[i.b] = R[i.c]; break;
+
+      case OP_PRINT: {
+        std::cout << R[i.b].to_string();
+        R[i.a].set_nil();
+        break;
+      }
+      case OP_ITOS: R[i.a].set(R[i.b].to_string()); break;
+      case OP_DTOS: {
+        std::string s = R[i.b].to_string();
+        // remove trailing 0s (keeping one digit after the '.')
+        for (int j = s.length() - 1; j > 0; j--) {
+          if (s[j] == '0' && s[j-1] != '.')
+            s = s.substr(0, j);
+          else
+            break;
+        }
+        R[i.a].set(s);
+        break;
+      }
+      case OP_STOI: {
+        try {
+          R[i.a].set(std::stoi(R[i.b].to_string()));
+        } catch (const std::exception& e) {
+          error("invalid int string '" + R[i.b].to_string() + "'",
+                fun, pc - 1);
+        }
+        break;
+      }
+      case OP_STOD: {
+        try {
+          R[i.a].set(std::stod(R[i.b].to_string()));
+        } catch (const std::exception& e) {
+          error("invalid double string '" + R[i.b].to_string() + "'",
+                fun, pc - 1);
+        }
+        break;
+      }
+      case OP_LENGTH: {
+        R[i.a].set((int)R[i.b].to_string().length());
+        break;
+      }
+      case OP_GET: {
+        int index;
+        std::string s;
+        R[i.b].value(index);
+        R[i.c].value(s);
+        if (index < 0 or index >= (int)s.length())
+          error("string index out of range", fun, pc - 1);
+        R[i.a].set(s[index]);
+        break;
+      }
+      case OP_READ: {
+        std::string s;
+        getline(std::cin, s);
+        R[i.a].set(s);
+        break;
+      }
+    }
+  }
+}
+
+#undef OPERANDS
+
+
+#endif